@@ -37,12 +37,14 @@ public class DFoundryFX : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
+        "Renderer",
       }
     );
 
     if (Target.bBuildEditor)
     {
       PrivateDependencyModuleNames.Add("UnrealEd");
+      PrivateDependencyModuleNames.Add("MaterialEditor");
     }
 
     DynamicallyLoadedModuleNames.AddRange(
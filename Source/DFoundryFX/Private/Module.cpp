@@ -3,6 +3,14 @@
 #include "StatData.h"
 #include "UObject/UObjectGlobals.h"
 #include "Materials/MaterialInterface.h"
+#if WITH_EDITOR
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionConstant.h"
+#include "Materials/MaterialExpressionTextureSampleParameter2D.h"
+#include "MaterialEditingLibrary.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+#endif
 
 DEFINE_LOG_CATEGORY(LogDFoundryFX);
 #define LOCTEXT_NAMESPACE "DFX_Module"
@@ -27,6 +35,124 @@ static FAutoConsoleCommand DFoundryFXEnabled(
   })
 );
 
+static FAutoConsoleCommand DFoundryFXBenchmarkRenderer(
+  TEXT("DFoundryFX.BenchmarkRenderer"),
+  TEXT("Alternate the batched and legacy ImGui renderers for N frames (default 600) and log ms/frame (game thread, then game + render thread) and triangles/sec."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    if (DFXThread.IsValid()) {
+      DFXThread->BenchmarkRenderer(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 600);
+    }
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXOverlayUpdateRate(
+  TEXT("DFoundryFX.OverlayUpdateRate"),
+  TEXT("Rebuild the overlay at N Hz into a cached render target (15, 30, 60...), 0 rebuilds every frame."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const int32 Rate = Args.Num() > 0 ? FMath::Max(0, FCString::Atoi(*Args[0])) : 0;
+    FDFX_StatData::OverlayUpdateRate.Store(Rate, EMemoryOrder::Relaxed);
+    UE_LOG(LogDFoundryFX, Log, TEXT("Thread: Overlay update rate %d Hz."), Rate);
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXStressShaderLog(
+  TEXT("DFoundryFX.StressShaderLog"),
+  TEXT("Fire shader log events from N threads (default 8), M events each (default 100000), and check none is lost or reordered."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const int32 Producers = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 8;
+    const int32 Events = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100000;
+    const bool bPassed = FDFX_StatData::StressShaderLog(Producers, Events);
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: Shader log stress %s."), bPassed ? TEXT("passed") : TEXT("FAILED"));
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXBenchmarkFrameSnapshot(
+  TEXT("DFoundryFX.BenchmarkFrameSnapshot"),
+  TEXT("Publish frame snapshots for S seconds (default 2) with N reader threads (default 4) and log the writer cost with and without readers."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const int32 Readers = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 4;
+    const float Seconds = Args.Num() > 1 ? FMath::Clamp(FCString::Atof(*Args[1]), 0.1f, 30.f) : 2.f;
+    const bool bPassed = FDFX_StatData::BenchmarkFrameSnapshot(Readers, Seconds);
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: Frame snapshot benchmark %s."), bPassed ? TEXT("passed") : TEXT("FAILED"));
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXOverlayBudget(
+  TEXT("DFoundryFX.OverlayBudget"),
+  TEXT("Overlay cost budget in ms per frame (default 0, off), the overlay degrades while over it. No argument sets 1 ms."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const float Budget = Args.Num() > 0 ? FMath::Max(0.f, FCString::Atof(*Args[0])) : 1.f;
+    FDFX_StatData::OverlayBudgetMs.store(Budget, std::memory_order_relaxed);
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: Overlay budget %.2f ms."), Budget);
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXBenchmarkPercentiles(
+  TEXT("DFoundryFX.BenchmarkPercentiles"),
+  TEXT("Feed N samples (default 1000000) of a known distribution to a percentile tracker, log the cost per sample and check the quantiles."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const int32 Samples = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1000, 100000000) : 1000000;
+    const bool bPassed = FDFX_StatData::BenchmarkPercentiles(Samples);
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: Percentile benchmark %s."), bPassed ? TEXT("passed") : TEXT("FAILED"));
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXBindStat(
+  TEXT("DFoundryFX.BindStat"),
+  TEXT("Record engine stats by short name (e.g. STAT_InitViews) into their own history, they can then be plotted from Settings > Graphs > Stat Channels."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    for (const FString& StatName : Args) {
+      FDFX_StatData::BindStatChannel(StatName);
+    }
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXStressPlot(
+  TEXT("DFoundryFX.StressPlot"),
+  TEXT("Toggle an ImPlot line of N points (default 1000000) and validate the vertex streams, draws and scissors the renderer submits for it."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    const int Points = Args.Num() > 0 ? FMath::Max(0, FCString::Atoi(*Args[0])) : 1000000;
+    FDFX_StatData::StressPlotPoints = (FDFX_StatData::StressPlotPoints > 0 && Args.Num() == 0) ? 0 : Points;
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXFontGlyphRanges(
+  TEXT("DFoundryFX.FontGlyphRanges"),
+  TEXT("Set the rasterized font glyph ranges and rebuild the atlas, e.g. 0x0020-0x007E,0x00B0. Empty uses ImGui default ranges."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    FDFX_StatData::FontGlyphRanges = FString::Join(Args, TEXT(","));
+    FDFX_StatData::FontAtlasRevision++;
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXFontAlpha8(
+  TEXT("DFoundryFX.FontAlpha8"),
+  TEXT("Use a single channel PF_G8 font atlas (1) or RGBA32 (0). Falls back to RGBA32 when M_ImGui_A8 is missing."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    FDFX_StatData::bFontAlpha8 = Args.Num() > 0 ? FCString::Atoi(*Args[0]) != 0 : !FDFX_StatData::bFontAlpha8;
+    FDFX_StatData::FontAtlasRevision++;
+  })
+);
+
+static FAutoConsoleCommand DFoundryFXVerifyVertexKernel(
+  TEXT("DFoundryFX.VerifyVertexKernel"),
+  TEXT("Compare the SIMD ImDrawVert conversion against the scalar reference bit-for-bit on N random vertices (default 4099)."),
+  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+  {
+    FDFX_Renderer::VerifyVertexKernel(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 4099);
+  })
+);
+
 
 void FDFX_Module::StartupModule()
 {
@@ -66,6 +192,7 @@ void FDFX_Module::StartupModule()
     MaterialInstance = UMaterialInstanceDynamic::Create(MasterMaterial, nullptr);
     MaterialInstance->AllocatePermutationResource();
     MaterialInstance->ClearParameterValues();
+    MaterialInstanceRGBA32 = MaterialInstance;
   }
   FontTexture = UTexture2D::CreateTransient(512, 64, PF_R8G8B8A8);
 
@@ -76,6 +203,23 @@ void FDFX_Module::StartupModule()
     FontTexture->AddToRoot();
   }
 
+  // Alpha8 atlas permutation, the RGBA32 atlas is used when the asset is not packaged.
+  MasterMaterialAlpha8 = LoadObject<UMaterialInterface>(nullptr, TEXT("Material'/DFoundryFX/M_ImGui_A8.M_ImGui_A8'"), nullptr, LOAD_NoWarn | LOAD_Quiet);
+#if WITH_EDITOR
+  if (!MasterMaterialAlpha8) {
+    MasterMaterialAlpha8 = CreateMaterialAlpha8(MasterMaterial);
+  }
+#endif
+  if (MasterMaterialAlpha8) {
+    MaterialInstanceAlpha8 = UMaterialInstanceDynamic::Create(MasterMaterialAlpha8, nullptr);
+    MaterialInstanceAlpha8->AllocatePermutationResource();
+    MaterialInstanceAlpha8->ClearParameterValues();
+    MasterMaterialAlpha8->AddToRoot();
+    MaterialInstanceAlpha8->AddToRoot();
+  } else {
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: M_ImGui_A8 not found, font atlas uses RGBA32."));
+  }
+
   //FDFX_Thread
   if (!FPlatformProcess::SupportsMultithreading()) {
     UE_LOG(LogDFoundryFX, Warning, TEXT("Module: Platform don't support Multithreads."));
@@ -87,9 +231,70 @@ void FDFX_Module::StartupModule()
 }
 
 
+#if WITH_EDITOR
+UMaterialInterface* FDFX_Module::CreateMaterialAlpha8(UMaterialInterface* Source)
+{
+  UMaterial* SourceMaterial = Source ? Source->GetMaterial() : nullptr;
+  if (!SourceMaterial) {
+    return nullptr;
+  }
+
+  // Derive M_ImGui_A8 from M_ImGui and save it into the plugin Content, so it is cooked with the plugin.
+  const FString PackageName = TEXT("/DFoundryFX/M_ImGui_A8");
+  UPackage* Package = CreatePackage(*PackageName);
+  UMaterial* Material = DuplicateObject<UMaterial>(SourceMaterial, Package, TEXT("M_ImGui_A8"));
+  Material->SetFlags(RF_Public | RF_Standalone);
+
+  // A PF_G8 atlas samples as (coverage, coverage, coverage, 1): alpha reads move to R, color reads become white.
+  UMaterialExpressionConstant* White = nullptr;
+  auto Remap = [&](FExpressionInput* Input)
+  {
+    UMaterialExpressionTextureSampleParameter2D* Sample = Input ? Cast<UMaterialExpressionTextureSampleParameter2D>(Input->Expression) : nullptr;
+    if (!Sample) {
+      return;
+    }
+    if (Input->OutputIndex == 4) {
+      Input->Connect(1, Sample);
+      return;
+    }
+    if (!White) {
+      White = Cast<UMaterialExpressionConstant>(UMaterialEditingLibrary::CreateMaterialExpression(Material, UMaterialExpressionConstant::StaticClass()));
+      White->R = 1.f;
+    }
+    Input->Connect(0, White);
+  };
+
+  TArray<UObject*> Subobjects;
+  GetObjectsWithOuter(Material, Subobjects, false);
+  for (UObject* Subobject : Subobjects) {
+    if (UMaterialExpression* Expression = Cast<UMaterialExpression>(Subobject)) {
+      for (FExpressionInput* Input : Expression->GetInputs()) {
+        Remap(Input);
+      }
+    }
+  }
+  for (int32 Property = 0; Property < MP_MAX; Property++) {
+    Remap(Material->GetExpressionInputForProperty((EMaterialProperty)Property));
+  }
+  UMaterialEditingLibrary::RecompileMaterial(Material);
+
+  FSavePackageArgs SaveArgs;
+  SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+  const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+  if (UPackage::SavePackage(Package, Material, *Filename, SaveArgs)) {
+    UE_LOG(LogDFoundryFX, Log, TEXT("Module: Created %s."), *Filename);
+  } else {
+    UE_LOG(LogDFoundryFX, Warning, TEXT("Module: Could not save %s, M_ImGui_A8 is only available in this session."), *Filename);
+  }
+  return Material;
+}
+#endif
+
+
 void FDFX_Module::ShutdownModule()
 {
   UE_LOG(LogDFoundryFX, Log, TEXT("Module: Closing DFoundryFX module."));
+  FDFX_StatData::UnbindStatChannels();
 
   if (!GDFXEnabled && DFXThread.IsValid()) {
     DFXThread->Stop();
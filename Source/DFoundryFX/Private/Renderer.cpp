@@ -0,0 +1,880 @@
+#include "Renderer.h"
+#include "Module.h"
+#include "MeshPassProcessor.h"
+#include "PrimitiveUniformShaderParameters.h"
+#include "RendererInterface.h"
+#include "SceneView.h"
+#include "Hash/CityHash.h"
+#include "RenderingThread.h"
+
+// ImU32 -> FColor is a R/B byte swap, only valid for the default ImGui RGBA packing.
+#if !defined(IMGUI_USE_BGRA_PACKED_COLOR) && PLATFORM_LITTLE_ENDIAN
+  #if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #define DFX_VERTEX_KERNEL_NEON 1
+    #include <arm_neon.h>
+  #elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+    #define DFX_VERTEX_KERNEL_SSE2 1
+    #include <emmintrin.h>
+  #endif
+#endif
+#ifndef DFX_VERTEX_KERNEL_NEON
+  #define DFX_VERTEX_KERNEL_NEON 0
+#endif
+#ifndef DFX_VERTEX_KERNEL_SSE2
+  #define DFX_VERTEX_KERNEL_SSE2 0
+#endif
+
+#define LOCTEXT_NAMESPACE "DFX_Renderer"
+DECLARE_CYCLE_STAT(TEXT("DFoundryFX_RendererBuild"), STAT_RendererBuild, STATGROUP_DFoundryFX);
+DECLARE_CYCLE_STAT(TEXT("DFoundryFX_RendererDraw"), STAT_RendererDraw, STATGROUP_DFoundryFX);
+
+static_assert(sizeof(ImDrawIdx) == sizeof(uint16), "FRawIndexBuffer expects 16-bit ImDrawIdx.");
+
+// Grow an arena array to the next power of two so steady state frames never reallocate.
+template <typename T>
+static void ReserveArena(TArray<T>& Array, int32 Num)
+{
+  if (Num > Array.Max()) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+    Array.Reserve(FMath::RoundUpToPowerOfTwo(Num));
+  }
+}
+
+static void UploadBuffer(FRHICommandListImmediate& RHICmdList, FRHIBuffer* Buffer, const void* Src, uint32 Size)
+{
+  if (Size == 0)
+    return;
+  void* Dst = RHICmdList.LockBuffer(Buffer, 0, Size, RLM_WriteOnly);
+  FMemory::Memcpy(Dst, Src, Size);
+  RHICmdList.UnlockBuffer(Buffer);
+}
+
+template <typename T>
+static void CopyImVector(ImVector<T>& Dst, const ImVector<T>& Src)
+{
+  if (Src.Size > Dst.Capacity) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+  }
+  Dst.resize(Src.Size);
+  if (Src.Size > 0) {
+    FMemory::Memcpy(Dst.Data, Src.Data, Src.size_in_bytes());
+  }
+}
+
+FDFX_DrawDataSnapshot::~FDFX_DrawDataSnapshot()
+{
+  for (ImDrawList* List : Lists) {
+    IM_DELETE(List);
+  }
+}
+
+void FDFX_DrawDataSnapshot::CopyFrom(const ImDrawData* Src)
+{
+  Reset();
+  if (!Src || !Src->Valid)
+    return;
+
+  // Only the output buffers are copied, the lists are never drawn into so they need no shared data.
+  while (Lists.Num() < Src->CmdListsCount) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+    Lists.Add(IM_NEW(ImDrawList)(nullptr));
+  }
+  for (int n = 0; n < Src->CmdListsCount; n++)
+  {
+    const ImDrawList* Src_List = Src->CmdLists[n];
+    ImDrawList* Dst_List = Lists[n];
+    CopyImVector(Dst_List->CmdBuffer, Src_List->CmdBuffer);
+    CopyImVector(Dst_List->IdxBuffer, Src_List->IdxBuffer);
+    CopyImVector(Dst_List->VtxBuffer, Src_List->VtxBuffer);
+    Dst_List->Flags = Src_List->Flags;
+    Owners.Add(Src_List);
+  }
+
+  DrawData = *Src;
+  DrawData.CmdLists = Lists.GetData();
+  DrawData.OwnerViewport = nullptr;
+}
+
+static void* ImGuiMalloc(size_t Size, void* UserData)
+{
+  FDFX_Renderer::ImGuiAllocationCount.Increment();
+  return FMemory::Malloc(Size);
+}
+
+static void ImGuiFree(void* Ptr, void* UserData)
+{
+  FMemory::Free(Ptr);
+}
+
+void FDFX_Renderer::InstallImGuiAllocator()
+{
+  ImGui::SetAllocatorFunctions(&ImGuiMalloc, &ImGuiFree);
+}
+
+FDFX_Renderer::~FDFX_Renderer()
+{
+  // Render resources must be released on the render thread.
+  FrameData.Reset();
+  for (TSharedPtr<FDFX_RenderData>& Slot : FramePool) {
+    ENQUEUE_RENDER_COMMAND(DFX_ReleaseRenderData)(
+      [Data = MoveTemp(Slot)](FRHICommandListImmediate& RHICmdList) mutable
+      {
+        Data.Reset();
+      });
+  }
+}
+
+void FDFX_Renderer::BeginFrame(bool bOverlayTarget)
+{
+  const int32 Growths = BufferGrowthCount.GetValue();
+  const int32 ImGuiAllocations = ImGuiAllocationCount.GetValue();
+  FrameBufferGrowths = Growths - LastBufferGrowthCount;
+  FrameImGuiAllocations = ImGuiAllocations - LastImGuiAllocationCount;
+  LastBufferGrowthCount = Growths;
+  LastImGuiAllocationCount = ImGuiAllocations;
+
+  // A slot is free once the render thread dropped its reference.
+  FrameData.Reset();
+  for (const TSharedPtr<FDFX_RenderData>& Slot : FramePool) {
+    if (Slot.IsUnique()) {
+      FrameData = Slot;
+      break;
+    }
+  }
+  if (!FrameData.IsValid()) {
+    BufferGrowthCount.Increment();
+    FrameData = MakeShared<FDFX_RenderData>(GMaxRHIFeatureLevel, GeometryCache);
+    FramePool.Add(FrameData);
+  }
+  FrameData->ResetFrame();
+  FrameData->bOverlayTarget = bOverlayTarget;
+}
+
+void FDFX_Renderer::Render(ImDrawData* DrawData, UCanvas* Canvas, const ImDrawList* const* ListOwners)
+{
+  if (BenchmarkFramesLeft <= 0) {
+    RenderBatched(DrawData, Canvas, ListOwners);
+    return;
+  }
+
+  // The batched path only records on the game thread and draws on the render thread, so each path is also timed
+  // up to an idle render thread: the canvas batches are flushed and the render commands drained before and after.
+  const bool bLegacy = (BenchmarkFramesLeft % 2) == 0;
+  FCanvas* m_Canvas = Canvas->Canvas;
+  if (m_Canvas) {
+    m_Canvas->Flush_GameThread();
+  }
+  FlushRenderingCommands();
+  const uint64 BeginTime = FPlatformTime::Cycles64();
+  if (bLegacy) {
+    RenderLegacy(DrawData, Canvas);
+  } else {
+    RenderBatched(DrawData, Canvas, ListOwners);
+  }
+  const uint64 GameThreadEnd = FPlatformTime::Cycles64();
+  if (m_Canvas) {
+    m_Canvas->Flush_GameThread();
+  }
+  FlushRenderingCommands();
+  FBenchmarkSample& Sample = bLegacy ? BenchmarkLegacy : BenchmarkBatched;
+  Sample.Cycles += GameThreadEnd - BeginTime;
+  Sample.FlushedCycles += FPlatformTime::Cycles64() - BeginTime;
+  Sample.Triangles += DrawData->TotalIdxCount / 3;
+  Sample.Frames++;
+
+  if (--BenchmarkFramesLeft == 0) {
+    LogBenchmark();
+  }
+}
+
+void FDFX_Renderer::RenderBatched(ImDrawData* DrawData, UCanvas* Canvas, const ImDrawList* const* ListOwners)
+{
+  FCanvas* m_Canvas = Canvas->Canvas;
+  if (!m_Canvas || m_Canvas->IsHitTesting() || DrawData->TotalVtxCount == 0 || !FrameData.IsValid())
+    return;
+
+  FDFX_RenderData* Data = FrameData.Get();
+  Data->MaterialRenderProxy = FDFX_Module::MaterialInstance->GetRenderProxy();
+  Data->Transform = m_Canvas->GetTransformStack().Top();
+  Data->RenderTarget = m_Canvas->GetRenderTarget();
+  Data->Time = m_Canvas->GetTime();
+  Data->bScaledToRenderTarget = m_Canvas->IsScaledToRenderTarget();
+  Data->bValidate = bValidateNextFrame;
+  bValidateNextFrame = false;
+
+  // Every command is drawn with the font material, a texture it cannot bind would be drawn with the atlas instead.
+  const ImTextureID FontTextureId = static_cast<ImTextureID>(FDFX_Module::FontTexture);
+
+  // ClipRect is in ImGui display space, scissors are in render target pixels.
+  const ImVec2 ClipOffset = DrawData->DisplayPos;
+  const ImVec2 ClipScale = DrawData->FramebufferScale;
+  const FIntRect TargetRect(FIntPoint(0, 0), Data->RenderTarget->GetSizeXY());
+
+  {
+    SCOPE_CYCLE_COUNTER(STAT_RendererBuild);
+    // The game thread only deep-copies the draw data, hashing and conversion happen on the render thread.
+    ReserveArena(Data->Vertices, DrawData->TotalVtxCount);
+    ReserveArena(Data->Indices, DrawData->TotalIdxCount);
+    ReserveArena(Data->DrawCmds, DrawData->CmdListsCount * 8);
+    ReserveArena(Data->DrawLists, DrawData->CmdListsCount);
+    for (int n = 0; n < DrawData->CmdListsCount; n++)
+    {
+      const ImDrawList* Cmd_List = DrawData->CmdLists[n];
+      FDFX_DrawList& DrawList = Data->DrawLists.AddDefaulted_GetRef();
+      DrawList.Owner = ListOwners ? ListOwners[n] : Cmd_List;
+      DrawList.VtxOffset = Data->Vertices.Num();
+      DrawList.VtxCount = Cmd_List->VtxBuffer.Size;
+      DrawList.IdxOffset = Data->Indices.Num();
+      DrawList.IdxCount = Cmd_List->IdxBuffer.Size;
+      DrawList.CmdOffset = Data->DrawCmds.Num();
+
+      Data->Vertices.Append(Cmd_List->VtxBuffer.Data, Cmd_List->VtxBuffer.Size);
+      Data->Indices.Append(Cmd_List->IdxBuffer.Data, Cmd_List->IdxBuffer.Size);
+
+      // ImGuiBackendFlags_RendererHasVtxOffset: lists larger than 64K vertices are split into commands
+      // with their own VtxOffset, so 16-bit indices are always relative to the command's base vertex.
+      for (int cmd_i = 0; cmd_i < Cmd_List->CmdBuffer.Size; cmd_i++)
+      {
+        const ImDrawCmd* pcmd = &Cmd_List->CmdBuffer[cmd_i];
+        FDFX_DrawCmd DrawCmd;
+        DrawCmd.ScissorRect = FIntRect(
+          FMath::FloorToInt((pcmd->ClipRect.x - ClipOffset.x) * ClipScale.x),
+          FMath::FloorToInt((pcmd->ClipRect.y - ClipOffset.y) * ClipScale.y),
+          FMath::CeilToInt((pcmd->ClipRect.z - ClipOffset.x) * ClipScale.x),
+          FMath::CeilToInt((pcmd->ClipRect.w - ClipOffset.y) * ClipScale.y));
+        DrawCmd.ScissorRect.Clip(TargetRect);
+        if (DrawCmd.ScissorRect.Area() <= 0) {
+          // Fully clipped (scrolled out rows, hidden plot areas), skip the draw.
+          continue;
+        }
+        DrawCmd.TextureId = pcmd->GetTexID();
+        if (DrawCmd.TextureId != FontTextureId) {
+          RejectTexture(DrawCmd.TextureId);
+          continue;
+        }
+        DrawCmd.VtxOffset = DrawList.VtxOffset + pcmd->VtxOffset;
+        DrawCmd.IdxOffset = DrawList.IdxOffset + pcmd->IdxOffset;
+        DrawCmd.ElemCount = pcmd->ElemCount;
+        if (Data->DrawCmds.Num() == Data->DrawCmds.Max()) {
+          BufferGrowthCount.Increment();
+        }
+        Data->DrawCmds.Add(DrawCmd);
+      }
+      DrawList.CmdCount = Data->DrawCmds.Num() - DrawList.CmdOffset;
+    }
+  }
+
+  // The render item is owned and deleted by the canvas.
+  FCanvasSortElement& SortElement = m_Canvas->GetSortElement(m_Canvas->TopDepthSortKey());
+  SortElement.RenderBatchArray.Add(new FDFX_RenderItem(FrameData));
+}
+
+void FDFX_Renderer::RecordGeometryCache(int32 Hits, int32 Lookups, int32 ReusedVertices, double MissCyclesPerVertex, uint64 OverheadCycles)
+{
+  // Smoothed on the render thread, published for the UI build. A frame without lists leaves both values unchanged.
+  static float HitRate = 0.f;
+  static float SavedMs = 0.f;
+  if (Lookups <= 0)
+    return;
+  // Net of what the cache itself costs: hashing every list and copying geometry in and out of it.
+  const double FrameSavedMs = (ReusedVertices * MissCyclesPerVertex - double(OverheadCycles)) * FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+  HitRate = HitRate * 0.9f + float(Hits) / Lookups * 0.1f;
+  SavedMs = SavedMs * 0.9f + float(FrameSavedMs) * 0.1f;
+  GeometryCacheHitRate.store(HitRate, std::memory_order_relaxed);
+  GeometryCacheSavedMs.store(SavedMs, std::memory_order_relaxed);
+}
+
+void FDFX_Renderer::RejectTexture(ImTextureID TextureId)
+{
+  if (TextureId != LastRejectedTexture) {
+    LastRejectedTexture = TextureId;
+    UE_LOG(LogDFoundryFX, Warning, TEXT("Renderer: Skipping draw commands of texture %p, only the font atlas can be bound."), TextureId);
+  }
+}
+
+void FDFX_Renderer::RenderLegacy(ImDrawData* DrawData, UCanvas* Canvas)
+{
+  // Reference path kept for DFoundryFX.BenchmarkRenderer: one K2_DrawMaterialTriangle per ImDrawCmd.
+  const ImTextureID FontTextureId = static_cast<ImTextureID>(FDFX_Module::FontTexture);
+  for (int n = 0; n < DrawData->CmdListsCount; n++)
+  {
+    const ImDrawList* Cmd_List = DrawData->CmdLists[n];
+
+    for (int cmd_i = 0; cmd_i < Cmd_List->CmdBuffer.Size; cmd_i++)
+    {
+      const ImDrawCmd* pcmd = &Cmd_List->CmdBuffer[cmd_i];
+      if (pcmd->GetTexID() != FontTextureId) {
+        RejectTexture(pcmd->GetTexID());
+        continue;
+      }
+      const ImDrawIdx* Idx_Buffer = Cmd_List->IdxBuffer.Data + pcmd->IdxOffset;
+      const ImDrawVert* Vtx_Buffer = Cmd_List->VtxBuffer.Data + pcmd->VtxOffset;
+      TArray<FCanvasUVTri> triangles;
+      for (unsigned int elem = 0; elem < pcmd->ElemCount / 3; elem++)
+      {
+        ImDrawVert v[] =
+        {
+          Vtx_Buffer[Idx_Buffer[elem * 3]],
+          Vtx_Buffer[Idx_Buffer[elem * 3 + 1]],
+          Vtx_Buffer[Idx_Buffer[elem * 3 + 2]]
+        };
+
+        ImVec4 Col[] =
+        {
+          ImGui::ColorConvertU32ToFloat4(v[0].col),
+          ImGui::ColorConvertU32ToFloat4(v[1].col),
+          ImGui::ColorConvertU32ToFloat4(v[2].col)
+        };
+
+        ImVec2 min_pos = v[0].pos;
+        ImVec2 max_pos = v[0].pos;
+        for (int i = 0; i < 3; i++)
+        {
+          if (v[i].pos.x < min_pos.x)
+            min_pos.x = v[i].pos.x;
+          if (v[i].pos.y < min_pos.y)
+            min_pos.y = v[i].pos.y;
+          if (v[i].pos.x > max_pos.x)
+            max_pos.x = v[i].pos.x;
+          if (v[i].pos.y > max_pos.y)
+            max_pos.y = v[i].pos.y;
+        }
+
+        ImVec2 min_uv = v[0].uv;
+        ImVec2 max_uv = v[0].uv;
+        for (int i = 0; i < 3; i++)
+        {
+          if (v[i].uv.x < min_uv.x)
+            min_uv.x = v[i].uv.x;
+          if (v[i].uv.y < min_uv.y)
+            min_uv.y = v[i].uv.y;
+          if (v[i].uv.x > max_uv.x)
+            max_uv.x = v[i].uv.x;
+          if (v[i].uv.y > max_uv.y)
+            max_uv.y = v[i].uv.y;
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+          if (v[i].pos.x < pcmd->ClipRect.x)
+          {
+            v[i].uv.x += (max_uv.x - v[i].uv.x) * (pcmd->ClipRect.x - v[i].pos.x) / (max_pos.x - v[i].pos.x);
+            v[i].pos.x = pcmd->ClipRect.x;
+          }
+          else if (v[i].pos.x > pcmd->ClipRect.z)
+          {
+            v[i].uv.x -= (v[i].uv.x - min_uv.x) * (v[i].pos.x - pcmd->ClipRect.z) / (v[i].pos.x - min_pos.x);
+            v[i].pos.x = pcmd->ClipRect.z;
+          }
+          if (v[i].pos.y < pcmd->ClipRect.y)
+          {
+            v[i].uv.y += (max_uv.y - v[i].uv.y) * (pcmd->ClipRect.y - v[i].pos.y) / (max_pos.y - v[i].pos.y);
+            v[i].pos.y = pcmd->ClipRect.y;
+          }
+          else if (v[i].pos.y > pcmd->ClipRect.w)
+          {
+            v[i].uv.y -= (v[i].uv.y - min_uv.y) * (v[i].pos.y - pcmd->ClipRect.w) / (v[i].pos.y - min_pos.y);
+            v[i].pos.y = pcmd->ClipRect.w;
+          }
+        }
+
+        FCanvasUVTri triangle;
+        triangle.V0_Pos = FVector2D(v[0].pos.x, v[0].pos.y);
+        triangle.V1_Pos = FVector2D(v[1].pos.x, v[1].pos.y);
+        triangle.V2_Pos = FVector2D(v[2].pos.x, v[2].pos.y);
+        triangle.V0_UV = FVector2D(v[0].uv.x, v[0].uv.y);
+        triangle.V1_UV = FVector2D(v[1].uv.x, v[1].uv.y);
+        triangle.V2_UV = FVector2D(v[2].uv.x, v[2].uv.y);
+        triangle.V0_Color = FLinearColor(Col[0].x, Col[0].y, Col[0].z, Col[0].w);
+        triangle.V1_Color = FLinearColor(Col[1].x, Col[1].y, Col[1].z, Col[1].w);
+        triangle.V2_Color = FLinearColor(Col[2].x, Col[2].y, Col[2].z, Col[2].w);
+        triangles.Push(triangle);
+      }
+
+      // Draw triangles
+      Canvas->K2_DrawMaterialTriangle(FDFX_Module::MaterialInstance, triangles);
+    }
+  }
+}
+
+void FDFX_Renderer::StartBenchmark(int32 Frames)
+{
+  BenchmarkBatched = FBenchmarkSample();
+  BenchmarkLegacy = FBenchmarkSample();
+  BenchmarkFramesLeft = FMath::Max(2, Frames);
+  UE_LOG(LogDFoundryFX, Log, TEXT("Renderer: Benchmark started for %d frames."), BenchmarkFramesLeft);
+}
+
+void FDFX_Renderer::LogBenchmark()
+{
+  for (int i = 0; i < 2; ++i)
+  {
+    const FBenchmarkSample& Sample = (i == 0) ? BenchmarkBatched : BenchmarkLegacy;
+    if (Sample.Frames == 0)
+      continue;
+    const double GameSeconds = Sample.Cycles * FPlatformTime::GetSecondsPerCycle64();
+    const double FlushedSeconds = Sample.FlushedCycles * FPlatformTime::GetSecondsPerCycle64();
+    const double TrianglesPerSec = FlushedSeconds > 0 ? Sample.Triangles / FlushedSeconds : 0;
+    UE_LOG(LogDFoundryFX, Log, TEXT("Renderer: Benchmark %s : %.4f ms/frame game thread, %.4f ms/frame game + render thread, %.2f Mtris/s (%d frames)."),
+      (i == 0) ? TEXT("Batched") : TEXT("Legacy"), GameSeconds * 1000.0 / Sample.Frames, FlushedSeconds * 1000.0 / Sample.Frames,
+      TrianglesPerSec / 1000000.0, Sample.Frames);
+  }
+}
+
+// *******************
+// Vertex conversion
+// *******************
+void FDFX_Renderer::ConvertVertices_Scalar(const ImDrawVert* Src, int32 Num, FVector3f* OutPositions, FVector2f* OutUVs, FColor* OutColors)
+{
+  for (int32 i = 0; i < Num; ++i)
+  {
+    const ImDrawVert& Vert = Src[i];
+    OutPositions[i] = FVector3f(Vert.pos.x, Vert.pos.y, 0.f);
+    OutUVs[i] = FVector2f(Vert.uv.x, Vert.uv.y);
+    OutColors[i] = FColor(
+      (Vert.col >> IM_COL32_R_SHIFT) & 0xFF,
+      (Vert.col >> IM_COL32_G_SHIFT) & 0xFF,
+      (Vert.col >> IM_COL32_B_SHIFT) & 0xFF,
+      (Vert.col >> IM_COL32_A_SHIFT) & 0xFF);
+  }
+}
+
+void FDFX_Renderer::ConvertVertices(const ImDrawVert* Src, int32 Num, FVector3f* OutPositions, FVector2f* OutUVs, FColor* OutColors)
+{
+  static_assert(sizeof(ImDrawVert) == 20, "Vertex kernel expects the default ImDrawVert layout (pos, uv, col).");
+  static_assert(sizeof(FVector3f) == 12 && sizeof(FVector2f) == 8 && sizeof(FColor) == 4, "Unexpected engine vertex layout.");
+
+  int32 i = 0;
+#if DFX_VERTEX_KERNEL_SSE2
+  // 4 vertices = 5 registers: [p0x p0y u0 v0] [c0 p1x p1y u1] [v1 c1 p2x p2y] [u2 v2 c2 p3x] [p3y u3 v3 c3]
+  const __m128 Zero = _mm_setzero_ps();
+  const __m128 MaskMidXY = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, 0));
+  const __m128i MaskAG = _mm_set1_epi32(0xFF00FF00);
+  const __m128i MaskLow = _mm_set1_epi32(0x000000FF);
+  for (; i + 4 <= Num; i += 4)
+  {
+    const float* In = reinterpret_cast<const float*>(Src + i);
+    const __m128 R0 = _mm_loadu_ps(In + 0);
+    const __m128 R1 = _mm_loadu_ps(In + 4);
+    const __m128 R2 = _mm_loadu_ps(In + 8);
+    const __m128 R3 = _mm_loadu_ps(In + 12);
+    const __m128 R4 = _mm_loadu_ps(In + 16);
+
+    // Positions: [p0x p0y 0 p1x] [p1y 0 p2x p2y] [0 p3x p3y 0]
+    const __m128 R1Z = _mm_move_ss(R1, Zero);
+    float* Pos = reinterpret_cast<float*>(OutPositions + i);
+    _mm_storeu_ps(Pos + 0, _mm_shuffle_ps(R0, R1Z, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm_storeu_ps(Pos + 4, _mm_shuffle_ps(R1Z, R2, _MM_SHUFFLE(3, 2, 0, 2)));
+    _mm_storeu_ps(Pos + 8, _mm_and_ps(_mm_shuffle_ps(R3, R4, _MM_SHUFFLE(0, 0, 3, 3)), MaskMidXY));
+
+    // UVs: [u0 v0 u1 v1] [u2 v2 u3 v3]
+    float* UV = reinterpret_cast<float*>(OutUVs + i);
+    const __m128 UV1 = _mm_shuffle_ps(R1, R2, _MM_SHUFFLE(0, 0, 3, 3));
+    _mm_storeu_ps(UV + 0, _mm_shuffle_ps(R0, UV1, _MM_SHUFFLE(2, 0, 3, 2)));
+    _mm_storeu_ps(UV + 4, _mm_shuffle_ps(R3, R4, _MM_SHUFFLE(2, 1, 1, 0)));
+
+    // Colors: gather [c0 c1 c2 c3] then swap R/B, ImU32 A8B8G8R8 -> FColor A8R8G8B8
+    const __m128 C01 = _mm_shuffle_ps(R1, R2, _MM_SHUFFLE(1, 1, 0, 0));
+    const __m128 C23 = _mm_shuffle_ps(R3, R4, _MM_SHUFFLE(3, 3, 2, 2));
+    const __m128i Col = _mm_castps_si128(_mm_shuffle_ps(C01, C23, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i Swapped = _mm_or_si128(_mm_and_si128(Col, MaskAG),
+      _mm_or_si128(_mm_slli_epi32(_mm_and_si128(Col, MaskLow), 16), _mm_and_si128(_mm_srli_epi32(Col, 16), MaskLow)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(OutColors + i), Swapped);
+  }
+#elif DFX_VERTEX_KERNEL_NEON
+  const float32x2_t Zero = vdup_n_f32(0.f);
+  const uint32x4_t MaskAG = vdupq_n_u32(0xFF00FF00);
+  const uint32x4_t MaskLow = vdupq_n_u32(0x000000FF);
+  for (; i + 4 <= Num; i += 4)
+  {
+    const ImDrawVert* In = Src + i;
+    const float32x2_t P0 = vld1_f32(&In[0].pos.x);
+    const float32x2_t P1 = vld1_f32(&In[1].pos.x);
+    const float32x2_t P2 = vld1_f32(&In[2].pos.x);
+    const float32x2_t P3 = vld1_f32(&In[3].pos.x);
+
+    // Positions: [p0x p0y 0 p1x] [p1y 0 p2x p2y] [0 p3x p3y 0]
+    float* Pos = reinterpret_cast<float*>(OutPositions + i);
+    vst1q_f32(Pos + 0, vcombine_f32(P0, vext_f32(Zero, P1, 1)));
+    vst1q_f32(Pos + 4, vcombine_f32(vext_f32(P1, Zero, 1), P2));
+    vst1q_f32(Pos + 8, vcombine_f32(vext_f32(Zero, P3, 1), vext_f32(P3, Zero, 1)));
+
+    float* UV = reinterpret_cast<float*>(OutUVs + i);
+    vst1q_f32(UV + 0, vcombine_f32(vld1_f32(&In[0].uv.x), vld1_f32(&In[1].uv.x)));
+    vst1q_f32(UV + 4, vcombine_f32(vld1_f32(&In[2].uv.x), vld1_f32(&In[3].uv.x)));
+
+    const uint32 Cols[4] = { In[0].col, In[1].col, In[2].col, In[3].col };
+    const uint32x4_t Col = vld1q_u32(Cols);
+    const uint32x4_t Swapped = vorrq_u32(vandq_u32(Col, MaskAG),
+      vorrq_u32(vshlq_n_u32(vandq_u32(Col, MaskLow), 16), vandq_u32(vshrq_n_u32(Col, 16), MaskLow)));
+    vst1q_u32(reinterpret_cast<uint32*>(OutColors + i), Swapped);
+  }
+#endif
+  // Tail, and the whole buffer without SIMD.
+  ConvertVertices_Scalar(Src + i, Num - i, OutPositions + i, OutUVs + i, OutColors + i);
+}
+
+bool FDFX_Renderer::VerifyVertexKernel(int32 NumVertices)
+{
+  FRandomStream Random(0xDF0F);
+  TArray<ImDrawVert> Src;
+  Src.SetNumUninitialized(NumVertices);
+  for (ImDrawVert& Vert : Src) {
+    Vert.pos = ImVec2(Random.FRandRange(-4096.f, 4096.f), Random.FRandRange(-4096.f, 4096.f));
+    Vert.uv = ImVec2(Random.FRand(), Random.FRand());
+    Vert.col = Random.GetUnsignedInt();
+  }
+
+  TArray<FVector3f> PositionsSIMD, PositionsScalar;
+  TArray<FVector2f> UVsSIMD, UVsScalar;
+  TArray<FColor> ColorsSIMD, ColorsScalar;
+  PositionsSIMD.SetNumZeroed(NumVertices); PositionsScalar.SetNumZeroed(NumVertices);
+  UVsSIMD.SetNumZeroed(NumVertices); UVsScalar.SetNumZeroed(NumVertices);
+  ColorsSIMD.SetNumZeroed(NumVertices); ColorsScalar.SetNumZeroed(NumVertices);
+
+  ConvertVertices(Src.GetData(), NumVertices, PositionsSIMD.GetData(), UVsSIMD.GetData(), ColorsSIMD.GetData());
+  ConvertVertices_Scalar(Src.GetData(), NumVertices, PositionsScalar.GetData(), UVsScalar.GetData(), ColorsScalar.GetData());
+
+  const bool bMatch =
+    FMemory::Memcmp(PositionsSIMD.GetData(), PositionsScalar.GetData(), NumVertices * sizeof(FVector3f)) == 0 &&
+    FMemory::Memcmp(UVsSIMD.GetData(), UVsScalar.GetData(), NumVertices * sizeof(FVector2f)) == 0 &&
+    FMemory::Memcmp(ColorsSIMD.GetData(), ColorsScalar.GetData(), NumVertices * sizeof(FColor)) == 0;
+
+  UE_LOG(LogDFoundryFX, Log, TEXT("Renderer: Vertex kernel (%s) %s scalar reference on %d vertices."),
+    DFX_VERTEX_KERNEL_SSE2 ? TEXT("SSE2") : (DFX_VERTEX_KERNEL_NEON ? TEXT("NEON") : TEXT("Scalar")),
+    bMatch ? TEXT("matches") : TEXT("DOES NOT match"), NumVertices);
+  return bMatch;
+}
+
+// *******************
+// Render thread
+// *******************
+uint64 FDFX_RenderData::HashFrame_RenderThread()
+{
+  // Per list: counts, vertex and index buffers, then the scissor and texture of every visible command.
+  const FIntPoint TargetSize = RenderTarget->GetSizeXY();
+  uint64 FrameHash = CityHash64(reinterpret_cast<const char*>(&TargetSize), sizeof(TargetSize));
+  if (DrawLists.Num() > ListHashes.Max()) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+  }
+  ListHashes.Reset(DrawLists.Num());
+  for (const FDFX_DrawList& DrawList : DrawLists)
+  {
+    const uint64 Counts[3] = { DrawList.VtxCount, DrawList.IdxCount, DrawList.CmdCount };
+    uint64 Hash = CityHash64(reinterpret_cast<const char*>(Counts), sizeof(Counts));
+    Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Vertices.GetData() + DrawList.VtxOffset), DrawList.VtxCount * sizeof(ImDrawVert), Hash);
+    Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Indices.GetData() + DrawList.IdxOffset), DrawList.IdxCount * sizeof(ImDrawIdx), Hash);
+    for (uint32 i = DrawList.CmdOffset; i < DrawList.CmdOffset + DrawList.CmdCount; ++i)
+    {
+      const struct { FIntRect ScissorRect; ImTextureID TextureId; } CmdKey = { DrawCmds[i].ScissorRect, DrawCmds[i].TextureId };
+      Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&CmdKey), sizeof(CmdKey), Hash);
+    }
+    ListHashes.Add(Hash);
+    FrameHash = CityHash64WithSeed(reinterpret_cast<const char*>(&Hash), sizeof(Hash), FrameHash);
+  }
+  return FrameHash;
+}
+
+void FDFX_RenderData::ConvertVertices_RenderThread()
+{
+  FDFX_GeometryCache& Cache = *GeometryCache;
+  Cache.FrameCounter++;
+
+  const int32 NumVertices = Vertices.Num();
+  ReserveArena(Positions, NumVertices);
+  ReserveArena(UVs, NumVertices);
+  ReserveArena(Colors, NumVertices);
+  Positions.SetNumUninitialized(NumVertices, false);
+  UVs.SetNumUninitialized(NumVertices, false);
+  Colors.SetNumUninitialized(NumVertices, false);
+
+  int32 Hits = 0;
+  uint64 MissCycles = 0;
+  uint64 CopyCycles = 0;
+  int32 MissVertices = 0;
+  for (int n = 0; n < DrawLists.Num(); n++)
+  {
+    const FDFX_DrawList& DrawList = DrawLists[n];
+    const int32 Num = DrawList.VtxCount;
+    FVector3f* OutPositions = Positions.GetData() + DrawList.VtxOffset;
+    FVector2f* OutUVs = UVs.GetData() + DrawList.VtxOffset;
+    FColor* OutColors = Colors.GetData() + DrawList.VtxOffset;
+
+    FDFX_GeometryCache::FEntry& Entry = Cache.Lists.FindOrAdd(DrawList.Owner);
+    Entry.LastFrame = Cache.FrameCounter;
+    if (Entry.Hash == ListHashes[n] && Entry.Positions.Num() == Num) {
+      Hits++;
+      const uint64 HitBegin = FPlatformTime::Cycles64();
+      FMemory::Memcpy(OutPositions, Entry.Positions.GetData(), Num * sizeof(FVector3f));
+      FMemory::Memcpy(OutUVs, Entry.UVs.GetData(), Num * sizeof(FVector2f));
+      FMemory::Memcpy(OutColors, Entry.Colors.GetData(), Num * sizeof(FColor));
+      CopyCycles += FPlatformTime::Cycles64() - HitBegin;
+    } else {
+      const uint64 MissBegin = FPlatformTime::Cycles64();
+      FDFX_Renderer::ConvertVertices(Vertices.GetData() + DrawList.VtxOffset, Num, OutPositions, OutUVs, OutColors);
+      const uint64 StoreBegin = FPlatformTime::Cycles64();
+      MissCycles += StoreBegin - MissBegin;
+      Entry.Hash = ListHashes[n];
+      ReserveArena(Entry.Positions, Num);
+      ReserveArena(Entry.UVs, Num);
+      ReserveArena(Entry.Colors, Num);
+      Entry.Positions.SetNumUninitialized(Num, false);
+      Entry.UVs.SetNumUninitialized(Num, false);
+      Entry.Colors.SetNumUninitialized(Num, false);
+      FMemory::Memcpy(Entry.Positions.GetData(), OutPositions, Num * sizeof(FVector3f));
+      FMemory::Memcpy(Entry.UVs.GetData(), OutUVs, Num * sizeof(FVector2f));
+      FMemory::Memcpy(Entry.Colors.GetData(), OutColors, Num * sizeof(FColor));
+      // Storing into the cache only exists because of it, it counts as overhead rather than conversion.
+      CopyCycles += FPlatformTime::Cycles64() - StoreBegin;
+      MissVertices += Num;
+    }
+  }
+
+  // Drop lists of closed windows. Only a conversion sweeps, and it has just stamped every list of the frame,
+  // frames reused whole from the GPU buffers never get here.
+  for (auto It = Cache.Lists.CreateIterator(); It; ++It)
+  {
+    if (It->Value.LastFrame != Cache.FrameCounter) {
+      It.RemoveCurrent();
+    }
+  }
+
+  // Saved time is estimated from the measured cost of converting a vertex.
+  if (MissVertices > 0) {
+    Cache.MissCyclesPerVertex = Cache.MissCyclesPerVertex * 0.9 + (double(MissCycles) / MissVertices) * 0.1;
+  }
+  FDFX_Renderer::RecordGeometryCache(Hits, DrawLists.Num(), NumVertices - MissVertices, Cache.MissCyclesPerVertex, HashCycles + CopyCycles);
+}
+
+void FDFX_RenderData::InitResources_RenderThread(FRHICommandListImmediate& RHICmdList)
+{
+  const uint32 NumVertices = Vertices.Num();
+  const uint32 NumIndices = Indices.Num();
+  FPositionVertexBuffer& PositionVertexBuffer = StaticMeshVertexBuffers.PositionVertexBuffer;
+  FStaticMeshVertexBuffer& StaticMeshVertexBuffer = StaticMeshVertexBuffers.StaticMeshVertexBuffer;
+  FColorVertexBuffer& ColorVertexBuffer = StaticMeshVertexBuffers.ColorVertexBuffer;
+
+  const bool bGrowVertices = NumVertices > VertexCapacity;
+  if (bGrowVertices) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+    VertexCapacity = FMath::RoundUpToPowerOfTwo(NumVertices);
+    PositionVertexBuffer.ReleaseResource();
+    StaticMeshVertexBuffer.ReleaseResource();
+    ColorVertexBuffer.ReleaseResource();
+    VertexFactory.ReleaseResource();
+
+    PositionVertexBuffer.Init(VertexCapacity);
+    StaticMeshVertexBuffer.SetUseFullPrecisionUVs(true);
+    StaticMeshVertexBuffer.Init(VertexCapacity, 1);
+    ColorVertexBuffer.Init(VertexCapacity);
+    for (uint32 i = 0; i < VertexCapacity; ++i)
+    {
+      StaticMeshVertexBuffer.SetVertexTangents(i, FVector3f(1, 0, 0), FVector3f(0, 1, 0), FVector3f(0, 0, 1));
+    }
+  }
+
+  // Buffers already holding this frame (static overlay) are neither converted nor uploaded again.
+  const uint64 HashBegin = FPlatformTime::Cycles64();
+  const uint64 FrameHash = HashFrame_RenderThread();
+  HashCycles = FPlatformTime::Cycles64() - HashBegin;
+  const bool bUpload = bGrowVertices || UploadedHash != FrameHash;
+  UploadedHash = FrameHash;
+  if (bUpload) {
+    ConvertVertices_RenderThread();
+  } else {
+    FDFX_Renderer::RecordGeometryCache(DrawLists.Num(), DrawLists.Num(), NumVertices, GeometryCache->MissCyclesPerVertex, HashCycles);
+  }
+
+  if (bGrowVertices) {
+    // Full precision UVs with one channel are stored as a plain FVector2f array.
+    FMemory::Memcpy(PositionVertexBuffer.GetVertexData(), Positions.GetData(), NumVertices * sizeof(FVector3f));
+    FMemory::Memcpy(StaticMeshVertexBuffer.GetTexCoordData(), UVs.GetData(), NumVertices * sizeof(FVector2f));
+    FMemory::Memcpy(ColorVertexBuffer.GetVertexData(), Colors.GetData(), NumVertices * sizeof(FColor));
+    PositionVertexBuffer.InitResource();
+    StaticMeshVertexBuffer.InitResource();
+    ColorVertexBuffer.InitResource();
+
+    FLocalVertexFactory::FDataType VFData;
+    PositionVertexBuffer.BindPositionVertexBuffer(&VertexFactory, VFData);
+    StaticMeshVertexBuffer.BindTangentVertexBuffer(&VertexFactory, VFData);
+    StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&VertexFactory, VFData);
+    StaticMeshVertexBuffer.BindLightMapVertexBuffer(&VertexFactory, VFData, 0);
+    ColorVertexBuffer.BindColorVertexBuffer(&VertexFactory, VFData);
+    VertexFactory.SetData(VFData);
+    VertexFactory.InitResource();
+  } else if (bUpload) {
+    UploadBuffer(RHICmdList, PositionVertexBuffer.VertexBufferRHI, Positions.GetData(), NumVertices * sizeof(FVector3f));
+    UploadBuffer(RHICmdList, StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, UVs.GetData(), NumVertices * sizeof(FVector2f));
+    UploadBuffer(RHICmdList, ColorVertexBuffer.VertexBufferRHI, Colors.GetData(), NumVertices * sizeof(FColor));
+  }
+
+  if (NumIndices > IndexCapacity) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+    IndexCapacity = FMath::RoundUpToPowerOfTwo(NumIndices);
+    IndexBuffer.ReleaseResource();
+    IndexBuffer.Indices.SetNumZeroed(IndexCapacity);
+    FMemory::Memcpy(IndexBuffer.Indices.GetData(), Indices.GetData(), NumIndices * sizeof(ImDrawIdx));
+    IndexBuffer.InitResource();
+  } else if (bUpload) {
+    UploadBuffer(RHICmdList, IndexBuffer.IndexBufferRHI, Indices.GetData(), NumIndices * sizeof(ImDrawIdx));
+  }
+
+  if (DrawCmds.Num() > MeshBatches.Num()) {
+    FDFX_Renderer::BufferGrowthCount.Increment();
+    MeshBatches.SetNum(FMath::RoundUpToPowerOfTwo(DrawCmds.Num()));
+  }
+  for (int i = 0; i < DrawCmds.Num(); ++i)
+  {
+    const FDFX_DrawCmd& DrawCmd = DrawCmds[i];
+    FMeshBatch& Mesh = MeshBatches[i];
+    Mesh.VertexFactory = &VertexFactory;
+    Mesh.MaterialRenderProxy = MaterialRenderProxy;
+    Mesh.ReverseCulling = false;
+    Mesh.bDisableBackfaceCulling = true;
+    Mesh.Type = PT_TriangleList;
+    Mesh.DepthPriorityGroup = SDPG_Foreground;
+
+    FMeshBatchElement& BatchElement = Mesh.Elements[0];
+    BatchElement.IndexBuffer = &IndexBuffer;
+    BatchElement.FirstIndex = DrawCmd.IdxOffset;
+    BatchElement.NumPrimitives = DrawCmd.ElemCount / 3;
+    BatchElement.BaseVertexIndex = DrawCmd.VtxOffset;
+    BatchElement.MinVertexIndex = 0;
+    BatchElement.MaxVertexIndex = NumVertices - DrawCmd.VtxOffset - 1;
+    BatchElement.PrimitiveUniformBuffer = GIdentityPrimitiveUniformBuffer.GetUniformBufferRHI();
+  }
+
+  if (bValidate) {
+    Validate_RenderThread();
+  }
+}
+
+bool FDFX_RenderData::Validate_RenderThread() const
+{
+  // The converted streams, against the scalar kernel.
+  const int32 NumVertices = Vertices.Num();
+  TArray<FVector3f> RefPositions;
+  TArray<FVector2f> RefUVs;
+  TArray<FColor> RefColors;
+  RefPositions.SetNumUninitialized(NumVertices);
+  RefUVs.SetNumUninitialized(NumVertices);
+  RefColors.SetNumUninitialized(NumVertices);
+  FDFX_Renderer::ConvertVertices_Scalar(Vertices.GetData(), NumVertices, RefPositions.GetData(), RefUVs.GetData(), RefColors.GetData());
+  const bool bStreams = Positions.Num() == NumVertices && UVs.Num() == NumVertices && Colors.Num() == NumVertices &&
+    FMemory::Memcmp(Positions.GetData(), RefPositions.GetData(), NumVertices * sizeof(FVector3f)) == 0 &&
+    FMemory::Memcmp(UVs.GetData(), RefUVs.GetData(), NumVertices * sizeof(FVector2f)) == 0 &&
+    FMemory::Memcmp(Colors.GetData(), RefColors.GetData(), NumVertices * sizeof(FColor)) == 0;
+
+  // Every submitted mesh batch: its range of the index buffer, the vertices it reaches from its base vertex,
+  // which must stay inside its own list, and its scissor rect inside the render target.
+  const FIntRect TargetRect(FIntPoint(0, 0), RenderTarget->GetSizeXY());
+  int32 SplitCmds = 0;
+  int32 InvalidCmds = 0;
+  int32 InvalidScissors = 0;
+  for (const FDFX_DrawList& DrawList : DrawLists)
+  {
+    for (uint32 c = DrawList.CmdOffset; c < DrawList.CmdOffset + DrawList.CmdCount; ++c)
+    {
+      const FDFX_DrawCmd& DrawCmd = DrawCmds[c];
+      const FMeshBatchElement& Element = MeshBatches[c].Elements[0];
+      SplitCmds += DrawCmd.VtxOffset > DrawList.VtxOffset ? 1 : 0;
+      bool bValid = Element.FirstIndex == DrawCmd.IdxOffset && Element.NumPrimitives * 3 == DrawCmd.ElemCount &&
+        Element.BaseVertexIndex == DrawCmd.VtxOffset && DrawCmd.IdxOffset + DrawCmd.ElemCount <= static_cast<uint32>(Indices.Num());
+      for (uint32 e = 0; bValid && e < DrawCmd.ElemCount; ++e)
+      {
+        const uint32 Vertex = DrawCmd.VtxOffset + Indices[DrawCmd.IdxOffset + e];
+        bValid = Vertex >= DrawList.VtxOffset && Vertex < DrawList.VtxOffset + DrawList.VtxCount;
+      }
+      InvalidCmds += bValid ? 0 : 1;
+      const FIntRect& Scissor = DrawCmd.ScissorRect;
+      const bool bScissor = Scissor.Area() > 0 && Scissor.Min.X >= TargetRect.Min.X && Scissor.Min.Y >= TargetRect.Min.Y &&
+        Scissor.Max.X <= TargetRect.Max.X && Scissor.Max.Y <= TargetRect.Max.Y;
+      InvalidScissors += bScissor ? 0 : 1;
+    }
+  }
+
+  UE_LOG(LogDFoundryFX, Log, TEXT("Renderer: Submitted frame %d vertices (streams %s), %d draws, %d with VtxOffset, %d out of range, %d bad scissors."),
+    NumVertices, bStreams ? TEXT("match") : TEXT("DO NOT match"), DrawCmds.Num(), SplitCmds, InvalidCmds, InvalidScissors);
+  return bStreams && InvalidCmds == 0 && InvalidScissors == 0;
+}
+
+void FDFX_RenderData::ReleaseResources_RenderThread()
+{
+  StaticMeshVertexBuffers.PositionVertexBuffer.ReleaseResource();
+  StaticMeshVertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+  StaticMeshVertexBuffers.ColorVertexBuffer.ReleaseResource();
+  IndexBuffer.ReleaseResource();
+  VertexFactory.ReleaseResource();
+}
+
+void FDFX_RenderData::RenderDrawCmds(FCanvasRenderContext& RenderContext, FMeshPassProcessorRenderState& DrawRenderState, const FSceneView& View)
+{
+  SCOPE_CYCLE_COUNTER(STAT_RendererDraw);
+  InitResources_RenderThread(RenderContext.GraphBuilder.RHICmdList);
+
+  for (int i = 0; i < DrawCmds.Num(); ++i)
+  {
+    if (MeshBatches[i].Elements[0].NumPrimitives == 0)
+      continue;
+    // DrawTileMesh records its pass with the viewport and scissor of the context it is given,
+    // so each ImDrawCmd gets a context carrying its own ClipRect as hardware scissor.
+    FCanvasRenderContext ScissorContext(RenderContext.GraphBuilder, RenderTarget, RenderContext.GetViewportRect(), DrawCmds[i].ScissorRect, bScaledToRenderTarget);
+    GetRendererModule().DrawTileMesh(ScissorContext, DrawRenderState, View, MeshBatches[i], false, FHitProxyId());
+  }
+}
+
+const FSceneView& FDFX_RenderItem::CreateView(FCanvasRenderContext& RenderContext, const FDFX_RenderData& InData)
+{
+  const FSceneViewFamily& ViewFamily = *RenderContext.Alloc<const FSceneViewFamily>(FSceneViewFamily::ConstructionValues(
+    InData.RenderTarget, nullptr, FEngineShowFlags(ESFIM_Game))
+    .SetTime(InData.Time)
+    .SetGammaCorrection(InData.RenderTarget->GetDisplayGamma()));
+
+  const FIntRect ViewRect(FIntPoint(0, 0), InData.RenderTarget->GetSizeXY());
+
+  FSceneViewInitOptions ViewInitOptions;
+  ViewInitOptions.ViewFamily = &ViewFamily;
+  ViewInitOptions.SetViewRectangle(ViewRect);
+  ViewInitOptions.ViewOrigin = FVector::ZeroVector;
+  ViewInitOptions.ViewRotationMatrix = FMatrix::Identity;
+  ViewInitOptions.ProjectionMatrix = InData.Transform.GetMatrix();
+  ViewInitOptions.BackgroundColor = FLinearColor::Black;
+  ViewInitOptions.OverlayColor = FLinearColor::White;
+
+  return *RenderContext.Alloc<const FSceneView>(ViewInitOptions);
+}
+
+bool FDFX_RenderItem::Render_RenderThread(FCanvasRenderContext& RenderContext, FMeshPassProcessorRenderState& DrawRenderState, const FCanvas* Canvas)
+{
+  check(Data.IsValid());
+  const FSceneView& View = CreateView(RenderContext, *Data);
+  Data->RenderDrawCmds(RenderContext, DrawRenderState, View);
+
+  // Buffers are referenced by the recorded passes, release them once the graph has executed.
+  RenderContext.DeferredRelease(MoveTemp(Data));
+  return true;
+}
+
+bool FDFX_RenderItem::Render_GameThread(const FCanvas* Canvas, FCanvasRenderThreadScope& RenderScope)
+{
+  check(Data.IsValid());
+  RenderScope.EnqueueRenderCommand(
+    [LocalData = MoveTemp(Data)](FCanvasRenderContext& RenderContext) mutable
+    {
+      FMeshPassProcessorRenderState DrawRenderState;
+      DrawRenderState.SetDepthStencilState(TStaticDepthStencilState<false, CF_Always>::GetRHI());
+      if (LocalData->bOverlayTarget) {
+        // Alpha accumulates coverage so the cached overlay target can be composited premultiplied.
+        DrawRenderState.SetBlendState(TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_One, BF_InverseSourceAlpha>::GetRHI());
+      } else {
+        // The back buffer alpha is left untouched.
+        DrawRenderState.SetBlendState(TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_Zero, BF_One>::GetRHI());
+      }
+
+      const FSceneView& View = CreateView(RenderContext, *LocalData);
+      LocalData->RenderDrawCmds(RenderContext, DrawRenderState, View);
+      RenderContext.DeferredRelease(MoveTemp(LocalData));
+    });
+  return true;
+}
+#undef LOCTEXT_NAMESPACE
@@ -2,6 +2,9 @@
 #include "Module.h"
 #include "Engine/GameViewportClient.h"
 #include "Stats/Stats.h"
+#include "Async/Async.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter64.h"
 #include "Windows/WindowsPlatformTime.h"
 
 #define LOCTEXT_NAMESPACE "DFX_StatData"
@@ -11,29 +14,164 @@ DECLARE_CYCLE_STAT(TEXT("DFoundryFX_StatMainWin"), STAT_StatMainWin, STATGROUP_D
 DECLARE_CYCLE_STAT(TEXT("DFoundryFX_StatPlotThread"), STAT_StatPlotThread, STATGROUP_DFoundryFX);
 DECLARE_CYCLE_STAT(TEXT("DFoundryFX_StatPlotFrame"), STAT_StatPlotFrame, STATGROUP_DFoundryFX);
 DECLARE_CYCLE_STAT(TEXT("DFoundryFX_StatPlotFPS"), STAT_StatPlotFPS, STATGROUP_DFoundryFX);
+DECLARE_CYCLE_STAT(TEXT("DFoundryFX_StatPlotHistogram"), STAT_StatPlotHistogram, STATGROUP_DFoundryFX);
 
-void FDFX_StatData::RunDFoundryFX(UGameViewportClient* Viewport, uint64 ImGuiThread)
+static const char* const ChannelNames[FDFX_StatData::ChannelNum] = { "Frame", "FPS", "Game", "Render", "GPU", "RHI", "Swap", "Input", "ImGui" };
+static const char* const BoundNames[FDFX_StatData::BoundNum] = { "Game", "Render", "GPU", "RHI", "Present" };
+
+// 40 hex digits of a SHA hash without going through FString.
+static void HashToText(const FSHAHash& Hash, char (&OutText)[41])
 {
-  m_Viewport = Viewport;
-  Viewport->GetViewportSize(ViewSize);
+  static const char Digits[] = "0123456789ABCDEF";
+  for (int i = 0; i < 20; i++) {
+    OutText[i * 2] = Digits[Hash.Hash[i] >> 4];
+    OutText[i * 2 + 1] = Digits[Hash.Hash[i] & 0xF];
+  }
+  OutText[40] = '\0';
+}
+
+void FDFX_StatData::PrepareDFoundryFX(UGameViewportClient* Viewport)
+{
+  for (const FString& Command : PendingCommands) {
+    Viewport->ConsoleCommand(Command);
+  }
+  PendingCommands.Reset();
+  FName StatGroup;
+  while (PendingStatGroups.Dequeue(StatGroup)) {
+    FString Group = StatGroup.ToString();
+    Group.RemoveFromStart(TEXT("STATGROUP_"));
+    Viewport->ConsoleCommand(TEXT("stat group enable ") + Group);
+  }
 
+  Viewport->GetViewportSize(ViewSize);
   float DPIScale = Viewport->GetDPIScale();
   if (DPIScale != 1.f)  {
     ViewSize.X = ViewSize.X / DPIScale;
     ViewSize.Y = ViewSize.Y / DPIScale;
   }
 
-  m_ImGuiThreadTime = 0.9 * m_ImGuiThreadTime + 0.1 * (ImGuiThread * FPlatformTime::GetSecondsPerCycle64());
+  for (auto& elem : aStatCmds) {
+    elem.Enable = Viewport->IsStatEnabled(elem.Command);
+  }
+  EnabledStats = *Viewport->GetEnabledStats();
+
+  const float MaxFPS = GEngine ? GEngine->GetMaxFPS() : 0.f;
+  PacingCapMs = MaxFPS > 0.f ? 1000.f / MaxFPS : 0.f;
+
+  CaptureEngineContext(Viewport);
+}
+
+void FDFX_StatData::CaptureEngineContext(UGameViewportClient* Viewport)
+{
+  // Only the open main window shows it, the first build still needs it for the initial settings.
+  FEngineContext& Context = EngineContext;
+  if (Context.bCaptured && !bMainWindowOpen)
+    return;
+  Context.bCaptured = true;
+
+  IConsoleManager& ConsoleManager = IConsoleManager::Get();
+  auto GetInt = [&ConsoleManager](const TCHAR* Name) {
+    IConsoleVariable* CVar = ConsoleManager.FindConsoleVariable(Name);
+    return CVar ? CVar->GetInt() : 0;
+  };
+  Context.MaxFPS = GetInt(TEXT("t.MaxFPS"));
+  Context.bVSync = GetInt(TEXT("r.VSync")) != 0;
+  Context.ScreenPercentage = GetInt(TEXT("r.ScreenPercentage"));
+  Context.ResolutionQuality = GetInt(TEXT("sg.ResolutionQuality"));
+  Context.ViewDistanceScale = GetInt(TEXT("r.ViewDistanceScale"));
+  Context.PostProcessQuality = GetInt(TEXT("sg.PostProcessQuality"));
+  Context.ShadowQuality = GetInt(TEXT("sg.ShadowQuality"));
+  Context.TextureQuality = GetInt(TEXT("sg.TextureQuality"));
+  Context.EffectsQuality = GetInt(TEXT("sg.EffectsQuality"));
+  Context.DetailMode = GetInt(TEXT("r.DetailMode"));
+  Context.SkeletalMeshLODBias = GetInt(TEXT("r.SkeletalMeshLODBias"));
+  Context.FullscreenMode = GetInt(TEXT("r.FullscreenMode"));
+  Context.bPipelineCacheEnabled = GetInt(TEXT("r.ShaderPipelineCache.Enabled")) != 0;
+  Context.PipelineCacheBatchSize = GetInt(TEXT("r.ShaderPipelineCache.BatchSize"));
+  Context.PipelineCacheBackgroundBatchSize = GetInt(TEXT("r.ShaderPipelineCache.BackgroundBatchSize"));
+  Context.bPipelineCacheLogPSO = GetInt(TEXT("r.ShaderPipelineCache.LogPSO")) != 0;
+  Context.bPipelineCacheSaveAfterPSOsLogged = GetInt(TEXT("r.ShaderPipelineCache.SaveAfterPSOsLogged")) != 0;
+
+  Context.bIsPlayInEditorViewport = Viewport->bIsPlayInEditorViewport;
+  Context.GetDPIScale = Viewport->GetDPIScale();
+  Context.GetDPIDerivedResolutionFraction = Viewport->GetDPIDerivedResolutionFraction();
+  Context.IsCursorVisible = Viewport->Viewport->IsCursorVisible();
+  Context.IsForegroundWindow = Viewport->Viewport->IsForegroundWindow();
+  Context.IsExclusiveFullscreen = Viewport->Viewport->IsExclusiveFullscreen();
+  Context.IsFullscreen = Viewport->Viewport->IsFullscreen();
+  Context.IsGameRenderingEnabled = Viewport->Viewport->IsGameRenderingEnabled();
+  Context.IsHDRViewport = Viewport->Viewport->IsHDRViewport();
+  Context.IsKeyboardAvailable = Viewport->Viewport->IsKeyboardAvailable(0);
+  Context.IsMouseAvailable = Viewport->Viewport->IsMouseAvailable(0);
+  Context.IsPenActive = Viewport->Viewport->IsPenActive();
+  Context.IsPlayInEditorViewport = Viewport->Viewport->IsPlayInEditorViewport();
+  Context.IsSlateViewport = Viewport->Viewport->IsSlateViewport();
+  Context.IsSoftwareCursorVisible = Viewport->Viewport->IsSoftwareCursorVisible();
+  Context.IsStereoRenderingAllowed = Viewport->Viewport->IsStereoRenderingAllowed();
+
+  if (GEngine) {
+    Context.IsEditor = GEngine->IsEditor();
+    Context.IsAllowedFramerateSmoothing = GEngine->IsAllowedFramerateSmoothing();
+    Context.bForceDisableFrameRateSmoothing = GEngine->bForceDisableFrameRateSmoothing;
+    Context.bSmoothFrameRate = GEngine->bSmoothFrameRate;
+    Context.MinDesiredFrameRate = GEngine->MinDesiredFrameRate;
+    Context.bUseFixedFrameRate = GEngine->bUseFixedFrameRate;
+    Context.FixedFrameRate = GEngine->FixedFrameRate;
+    Context.bCanBlueprintsTickByDefault = GEngine->bCanBlueprintsTickByDefault;
+    Context.IsControllerIdUsingPlatformUserId = GEngine->IsControllerIdUsingPlatformUserId();
+    Context.IsStereoscopic3D = GEngine->IsStereoscopic3D(Viewport->Viewport);
+    Context.IsVanillaProduct = GEngine->IsVanillaProduct();
+    Context.HasMultipleLocalPlayers = GEngine->HasMultipleLocalPlayers(Viewport->GetWorld());
+    Context.AreEditorAnalyticsEnabled = GEngine->AreEditorAnalyticsEnabled();
+    Context.bAllowMultiThreadedAnimationUpdate = GEngine->bAllowMultiThreadedAnimationUpdate;
+    Context.bDisableAILogging = GEngine->bDisableAILogging;
+    Context.bEnableOnScreenDebugMessages = GEngine->bEnableOnScreenDebugMessages;
+    Context.bEnableOnScreenDebugMessagesDisplay = GEngine->bEnableOnScreenDebugMessagesDisplay;
+    Context.bEnableEditorPSysRealtimeLOD = GEngine->bEnableEditorPSysRealtimeLOD;
+    Context.bEnableVisualLogRecordingOnStart = GEngine->bEnableVisualLogRecordingOnStart;
+    Context.bGenerateDefaultTimecode = GEngine->bGenerateDefaultTimecode;
+    Context.bIsInitialized = GEngine->bIsInitialized;
+    Context.bLockReadOnlyLevels = GEngine->bLockReadOnlyLevels;
+    Context.bOptimizeAnimBlueprintMemberVariableAccess = GEngine->bOptimizeAnimBlueprintMemberVariableAccess;
+    Context.bPauseOnLossOfFocus = GEngine->bPauseOnLossOfFocus;
+    Context.bRenderLightMapDensityGrayscale = GEngine->bRenderLightMapDensityGrayscale;
+    Context.bShouldGenerateLowQualityLightmaps_DEPRECATED = GEngine->bShouldGenerateLowQualityLightmaps_DEPRECATED;
+    Context.BSPSelectionHighlightIntensity = GEngine->BSPSelectionHighlightIntensity;
+    Context.bStartedLoadMapMovie = GEngine->bStartedLoadMapMovie;
+    Context.bSubtitlesEnabled = GEngine->bSubtitlesEnabled;
+    Context.bSubtitlesForcedOff = GEngine->bSubtitlesForcedOff;
+    Context.bSuppressMapWarnings = GEngine->bSuppressMapWarnings;
+    Context.DisplayGamma = GEngine->DisplayGamma;
+    Context.IsAutosaving = GEngine->IsAutosaving();
+    Context.MaximumLoopIterationCount = GEngine->MaximumLoopIterationCount;
+    Context.MaxLightMapDensity = GEngine->MaxLightMapDensity;
+    Context.MaxOcclusionPixelsFraction = GEngine->MaxOcclusionPixelsFraction;
+    Context.MaxParticleResize = GEngine->MaxParticleResize;
+    Context.MaxParticleResizeWarn = GEngine->MaxParticleResizeWarn;
+    Context.MaxPixelShaderAdditiveComplexityCount = GEngine->MaxPixelShaderAdditiveComplexityCount;
+    Context.UseStaticMeshMinLODPerQualityLevels = GEngine->UseStaticMeshMinLODPerQualityLevels;
+  }
+
+  if (const FStatHitchesData* Hitches = Viewport->GetStatHitchesData()) {
+    Context.StatHitches = *Hitches;
+  }
+}
+
+void FDFX_StatData::ConsoleCommand(const FString& Command)
+{
+  PendingCommands.Add(Command);
+}
+
+void FDFX_StatData::RunDFoundryFX()
+{
+  DrainShaderLog();
 
   { 
     SCOPE_CYCLE_COUNTER(STAT_StatLoadDefault);
     LoadDefaultValues(ViewSize);
   }
+  ShownFrame = ReadFrameSnapshot();
 
-  { 
-    SCOPE_CYCLE_COUNTER(STAT_StatUpdate);
-    UpdateStats();
-  }
   { 
     SCOPE_CYCLE_COUNTER(STAT_StatMainWin);
     MainWindow();
@@ -59,49 +197,646 @@ void FDFX_StatData::RunDFoundryFX(UGameViewportClient* Viewport, uint64 ImGuiThr
         LoadFPSPlot();
       }
     }
+    if (pwHistogram.bShowPlot) {
+      {
+        SCOPE_CYCLE_COUNTER(STAT_StatPlotHistogram);
+        LoadHistogramPlot();
+      }
+    }
+  }
+
+  if (StressPlotPoints > 0) {
+    LoadStressPlot();
   }
 
   //EnableDebugWindow();
 }
 
-void FDFX_StatData::UpdateStats()
+void FDFX_StatData::SampleDFoundryFX(uint64 ImGuiThread, uint64 UIBuild)
+{
+  LastImGuiThreadTime = ImGuiThread * FPlatformTime::GetSecondsPerCycle64();
+  Frame.UIBuildTime = 0.9 * Frame.UIBuildTime + 0.1 * (UIBuild * FPlatformTime::GetSecondsPerCycle64() * 1000);
+
+  // The first RunDFoundryFX loads the defaults and takes the first sample.
+  if (!bIsDefaultLoaded)
+    return;
+
+  SCOPE_CYCLE_COUNTER(STAT_StatUpdate);
+  FFrameSample Sample;
+  while (FrameSamples.Dequeue(Sample)) {
+    UpdateStats(Sample);
+  }
+  if (Frame.Time - LastPercentileUpdate >= 0.25) {
+    LastPercentileUpdate = Frame.Time;
+    Percentiles.Update();
+  }
+}
+
+void FDFX_StatData::PublishFrameClock()
 {
+  FFrameClock Clock;
   if (FApp::IsBenchmarking() || FApp::UseFixedTimeStep()) {
-    m_CurrentTime = FPlatformTime::Seconds();
-    if (m_LastTime == 0) 
-      m_LastTime = m_CurrentTime;
-    m_DiffTime = m_CurrentTime - m_LastTime;
-    m_LastTime = m_CurrentTime;
+    Clock.Time = FPlatformTime::Seconds();
+    if (LastPublishedTime == 0) 
+      LastPublishedTime = Clock.Time;
+    Clock.DeltaTime = Clock.Time - LastPublishedTime;
+    LastPublishedTime = Clock.Time;
   } else {
-    m_CurrentTime = FApp::GetCurrentTime();
-    m_LastTime = FApp::GetLastTime();
-    m_DiffTime = m_CurrentTime - m_LastTime;
+    Clock.Time = FApp::GetCurrentTime();
+    Clock.DeltaTime = Clock.Time - FApp::GetLastTime();
   }
+  Clock.FrameNumber = GFrameCounter;
 
-  m_FrameCount = FStats::GameThreadStatsFrame.Load(EMemoryOrder::Relaxed);
-  m_FrameTime = 0.9 * m_FrameTime + 0.1 * (m_DiffTime * 1000.0f);
-  m_FramesPerSecond = static_cast<int>(round(1000 / m_FrameTime));
-  m_GameThreadTime = 0.9 * m_GameThreadTime + 0.1 * FPlatformTime::ToMilliseconds(GGameThreadTime);
-  m_RenderThreadTime = 0.9 * m_RenderThreadTime + 0.1 * FPlatformTime::ToMilliseconds(GRenderThreadTime);
-  m_GPUFrameTime = 0.9 * m_GPUFrameTime + 0.1 * FPlatformTime::ToMilliseconds(GGPUFrameTime);
-  m_RHIThreadTime = 0.9 * m_RHIThreadTime + 0.1 * FPlatformTime::ToMilliseconds(GWorkingRHIThreadTime); // GRHIThreadTime display some crazy values on Shipping builds, changed to GWorkingRHIThreadTime.
-  m_SwapBufferTime = 0.9 * m_SwapBufferTime + 0.1 * FPlatformTime::ToMilliseconds(GSwapBufferTime);
-  m_InputLatencyTime = 0.9 * m_InputLatencyTime + 0.1 * FPlatformTime::ToMilliseconds(GInputLatencyTimer.DeltaTime);
+  // Only fills up while the collector is paused.
+  if (!FrameClocks.Enqueue(Clock)) {
+    DroppedFrameSamples.Increment();
+  }
+}
+
+FDFX_StatData::FFrameSample FDFX_StatData::ReadFrameSample(const FFrameClock& Clock)
+{
+  FFrameSample Sample;
+  Sample.Time = Clock.Time;
+  Sample.DeltaTime = Clock.DeltaTime;
+  Sample.FrameNumber = Clock.FrameNumber;
+  Sample.GameThreadTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+  Sample.RenderThreadTime = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+  Sample.GPUFrameTime = FPlatformTime::ToMilliseconds(GGPUFrameTime);
+  Sample.RHIThreadTime = FPlatformTime::ToMilliseconds(GWorkingRHIThreadTime); // GRHIThreadTime display some crazy values on Shipping builds, changed to GWorkingRHIThreadTime.
+  Sample.SwapBufferTime = FPlatformTime::ToMilliseconds(GSwapBufferTime);
+  Sample.InputLatencyTime = FPlatformTime::ToMilliseconds(GInputLatencyTimer.DeltaTime);
+  Sample.DrawCalls = GNumDrawCallsRHI[0];
+  Sample.Primitives = GNumPrimitivesDrawnRHI[0];
+  const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+  Sample.UsedPhysicalMemory = MemoryStats.UsedPhysical;
+  Sample.UsedVirtualMemory = MemoryStats.UsedVirtual;
+  return Sample;
+}
+
+void FDFX_StatData::CollectFrameSamples()
+{
+  // The thread timings are the engine globals at collection time, the clock is the one of the frame.
+  // The sample ring is drained every HUD frame, it only fills up when the overlay stops rendering.
+  FFrameClock Clock;
+  while (FrameClocks.Dequeue(Clock)) {
+    if (!FrameSamples.Enqueue(ReadFrameSample(Clock))) {
+      DroppedFrameSamples.Increment();
+    }
+  }
+}
+
+void FDFX_StatData::UpdateStats(const FFrameSample& Sample)
+{
+  Frame.FrameNumber = Sample.FrameNumber;
+  Frame.Time = Sample.Time;
+  Frame.DeltaTime = Sample.DeltaTime;
+
+  Frame.StatsFrame = FStats::GameThreadStatsFrame.Load(EMemoryOrder::Relaxed);
+  Frame.Raw[ChannelFrame] = Frame.DeltaTime * 1000.0;
+  Frame.Raw[ChannelFPS] = Frame.DeltaTime > 0 ? 1.0 / Frame.DeltaTime : 0.0;
+  Frame.Raw[ChannelGame] = Sample.GameThreadTime;
+  Frame.Raw[ChannelRender] = Sample.RenderThreadTime;
+  Frame.Raw[ChannelGPU] = Sample.GPUFrameTime;
+  Frame.Raw[ChannelRHI] = Sample.RHIThreadTime;
+  Frame.Raw[ChannelSwap] = Sample.SwapBufferTime;
+  Frame.Raw[ChannelInput] = Sample.InputLatencyTime;
+  Frame.Raw[ChannelImGui] = LastImGuiThreadTime;
+
+  float Filtered[ChannelNum];
+  for (int i = 0; i < ChannelNum; i++) {
+    Filtered[i] = Filters[i].Add(Frame.Time, Frame.DeltaTime, Frame.Raw[i], static_cast<EDFX_Filter>(FilterModes[i]), FilterTimeConstant, FilterWindow);
+  }
+  Frame.FrameTime = Filtered[ChannelFrame];
+  Frame.FramesPerSecond = Frame.FrameTime > 0 ? static_cast<int>(round(1000 / Frame.FrameTime)) : 0;
+  Frame.GameThreadTime = Filtered[ChannelGame];
+  Frame.RenderThreadTime = Filtered[ChannelRender];
+  Frame.GPUFrameTime = Filtered[ChannelGPU];
+  Frame.RHIThreadTime = Filtered[ChannelRHI];
+  Frame.SwapBufferTime = Filtered[ChannelSwap];
+  Frame.InputLatencyTime = Filtered[ChannelInput];
+  Frame.ImGuiThreadTime = Filtered[ChannelImGui];
+  Frame.DrawCalls = Sample.DrawCalls;
+  Frame.Primitives = Sample.Primitives;
+  Frame.UsedPhysicalMemory = Sample.UsedPhysicalMemory;
+  Frame.UsedVirtualMemory = Sample.UsedVirtualMemory;
+  PublishedFrame.Write(Frame);
+
+  // The long history keeps the unsmoothed values, its min/max must show single-frame spikes.
+  FHistoryBucket HistorySample;
+  double SampleValues[ChannelNum];
+  HistorySample.Count = 1;
+  for (int i = 0; i < ChannelNum; i++) {
+    SampleValues[i] = Frame.Raw[i];
+    HistorySample.Min[i] = HistorySample.Max[i] = HistorySample.Sum[i] = SampleValues[i];
+  }
+  AddHistoryLevels(Frame.Time, HistorySample);
+  Percentiles.Add(Frame.Time, SampleValues);
+  AddBoundSample(ClassifyFrame());
+  DetectHitch();
+  UpdatePacing();
+
+  // Over budget the history is decimated, fewer points to plot.
+  const int HistoryStride = OverlayDegradeLevel >= DegradeMinimal ? 4 : (OverlayDegradeLevel == DegradeRate15 ? 2 : 1);
+  if (++HistorySkipped < HistoryStride)
+    return;
+  HistorySkipped = 0;
 
   // Save data for ImPlot
-  HistoryTime.Add(m_CurrentTime);
-  FrameCount.Add(ImPlotFrameCount);
-  FrameTime.Add(m_FrameTime);
-  FramesPerSecond.Add( static_cast<double>(m_FramesPerSecond) );
-  GameThreadTime.Add(m_GameThreadTime);
-  RenderThreadTime.Add(m_RenderThreadTime);
-  GPUFrameTime.Add(m_GPUFrameTime);
-  RHIThreadTime.Add(m_RHIThreadTime);
-  SwapBufferTime.Add(m_SwapBufferTime);
-  InputLatencyTime.Add(m_InputLatencyTime);
-  ImGuiThreadTime.Add(m_ImGuiThreadTime);
+  if (Frame.Time - HistoryBaseTime >= HistoryRebaseSeconds) {
+    RebaseHistory(Frame.Time);
+  }
+  History.Set(ChannelFrame, Frame.FrameTime);
+  History.Set(ChannelFPS, static_cast<float>(Frame.FramesPerSecond));
+  History.Set(ChannelGame, Frame.GameThreadTime);
+  History.Set(ChannelRender, Frame.RenderThreadTime);
+  History.Set(ChannelGPU, Frame.GPUFrameTime);
+  History.Set(ChannelRHI, Frame.RHIThreadTime);
+  History.Set(ChannelSwap, Frame.SwapBufferTime);
+  History.Set(ChannelInput, Frame.InputLatencyTime);
+  History.Set(ChannelImGui, Frame.ImGuiThreadTime);
+  if (PacingChannel != INDEX_NONE) {
+    History.Set(PacingChannel, LastFrameDelta);
+  }
+  UpdateStatChannels();
+  History.Add(static_cast<float>(Frame.Time - HistoryBaseTime));
 
   ImPlotFrameCount++;
+
+  if (LastHistoryTime > 0 && Frame.Time > LastHistoryTime) {
+    const double Interval = Frame.Time - LastHistoryTime;
+    HistorySampleInterval = HistorySampleInterval > 0 ? 0.95 * HistorySampleInterval + 0.05 * Interval : Interval;
+  }
+  LastHistoryTime = Frame.Time;
+  if (Frame.Time - LastHistoryFit >= 1.0) {
+    LastHistoryFit = Frame.Time;
+    FitHistory();
+  }
+}
+
+FDFX_StatData::EBoundThread FDFX_StatData::ClassifyFrame()
+{
+  const float FrameTime = Frame.Raw[ChannelFrame];
+  EBoundThread Bound = BoundGame;
+  float BoundTime = Frame.Raw[ChannelGame];
+  if (Frame.Raw[ChannelRender] > BoundTime) { Bound = BoundRender; BoundTime = Frame.Raw[ChannelRender]; }
+  if (Frame.Raw[ChannelGPU] > BoundTime) { Bound = BoundGPU; BoundTime = Frame.Raw[ChannelGPU]; }
+  if (Frame.Raw[ChannelRHI] > BoundTime) { Bound = BoundRHI; BoundTime = Frame.Raw[ChannelRHI]; }
+
+  // No thread worked for most of the frame: it waited on the present (VSync, frame rate cap).
+  if (FrameTime > 0.f && (BoundTime < 0.8f * FrameTime || Frame.Raw[ChannelSwap] > 0.25f * FrameTime)) {
+    Bound = BoundPresent;
+  }
+  return Bound;
+}
+
+void FDFX_StatData::AddBoundSample(EBoundThread Bound)
+{
+  const int32 Capacity = 16384;
+  if (BoundSamples.Num() != Capacity) {
+    BoundSamples.SetNumUninitialized(Capacity);
+  }
+
+  // Same window as the raw history.
+  const double Window = FMath::Min(StatHistoryGlobal, static_cast<float>(StatHistoryMax));
+  while (BoundCount > 0) {
+    const FBoundSample& Oldest = BoundSamples[(BoundHead + Capacity - BoundCount) % Capacity];
+    if (BoundCount < Capacity && Oldest.Time >= Frame.Time - Window)
+      break;
+    BoundCounts[Oldest.Bound]--;
+    BoundCount--;
+  }
+  BoundSamples[BoundHead] = { Frame.Time, Bound };
+  BoundHead = (BoundHead + 1) % Capacity;
+  BoundCounts[Bound]++;
+  BoundCount++;
+}
+
+void FDFX_StatData::DrawBoundBar(float Width)
+{
+  // Classes follow the thread plot colours, the present uses the swap colour.
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  const ImVec2 pos = ImGui::GetCursorScreenPos();
+  const float Height = ImGui::GetTextLineHeight() * 0.6f;
+  float x = pos.x;
+  int Dominant = 0;
+  for (int i = 0; i < BoundNum; i++) {
+    const float Share = GetBoundShare(static_cast<EBoundThread>(i));
+    if (Share > GetBoundShare(static_cast<EBoundThread>(Dominant)))
+      Dominant = i;
+    const float SegmentWidth = Width * Share;
+    if (SegmentWidth <= 0.f)
+      continue;
+    draw_list->AddRectFilled(ImVec2(x, pos.y), ImVec2(x + SegmentWidth, pos.y + Height), ImColor(pwThreadColor[i].PlotShadeColor));
+    x += SegmentWidth;
+  }
+  draw_list->AddRect(pos, ImVec2(pos.x + Width, pos.y + Height), ImColor(ImGui::GetStyleColorVec4(ImGuiCol_Border)));
+  ImGui::Dummy(ImVec2(Width, Height + 2));
+  if (BoundCount > 0) {
+    ImGui::Text("%s-bound %3.0f%%", BoundNames[Dominant], GetBoundShare(static_cast<EBoundThread>(Dominant)) * 100.f);
+  }
+}
+
+void FDFX_StatData::DetectHitch()
+{
+  // The median needs a few seconds of samples before it means anything.
+  const float Median = Percentiles.GetWindow(ChannelFrame).P50;
+  if (Percentiles.GetWindowCount() < 60 || Median <= 0.f)
+    return;
+
+  const float FrameTime = Frame.Raw[ChannelFrame];
+  float Threshold = HitchMedianFactor * Median;
+  if (HitchBudgetMs > 0.f) {
+    Threshold = FMath::Min(Threshold, HitchBudgetMs);
+  }
+  if (FrameTime <= Threshold)
+    return;
+
+  FHitchEvent Event;
+  Event.Time = Frame.Time;
+  Event.FrameNumber = Frame.FrameNumber;
+  Event.FrameTime = FrameTime;
+  Event.Threshold = Threshold;
+  Event.GameThreadTime = Frame.Raw[ChannelGame];
+  Event.RenderThreadTime = Frame.Raw[ChannelRender];
+  Event.GPUFrameTime = Frame.Raw[ChannelGPU];
+  Event.RHIThreadTime = Frame.Raw[ChannelRHI];
+  Event.BoundThread = ClassifyFrame();
+
+  if (HitchLog.Num() < HitchLogSize) {
+    HitchLog.Add(Event);
+  } else {
+    HitchLog[HitchLogHead] = Event;
+  }
+  HitchLogHead = (HitchLogHead + 1) % HitchLogSize;
+  HitchCount++;
+}
+
+void FDFX_StatData::DrawHitchLog()
+{
+  static ImGuiTableFlags Flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter |
+    ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp;
+  const ImVec2 outer_size = ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 12);
+
+  ImGui::Text("Threshold : %.1f x P50 (%4.3f ms)%s", HitchMedianFactor, HitchMedianFactor * Percentiles.GetWindow(ChannelFrame).P50,
+    HitchBudgetMs > 0.f ? " or budget" : "");
+  if (!ImGui::BeginTable("##tblHitchLog", 8, Flags, outer_size))
+    return;
+
+  ImGui::TableSetupScrollFreeze(0, 1);
+  ImGui::TableSetupColumn("Time (s)");
+  ImGui::TableSetupColumn("Frame");
+  ImGui::TableSetupColumn("Frame (ms)");
+  ImGui::TableSetupColumn("Game");
+  ImGui::TableSetupColumn("Render");
+  ImGui::TableSetupColumn("GPU");
+  ImGui::TableSetupColumn("RHI");
+  ImGui::TableSetupColumn("Bound");
+  ImGui::TableHeadersRow();
+  // Newest first, only the visible rows are submitted.
+  ImGuiListClipper Clipper;
+  Clipper.Begin(HitchLog.Num());
+  while (Clipper.Step())
+  {
+    for (int Row = Clipper.DisplayStart; Row < Clipper.DisplayEnd; Row++)
+    {
+      const FHitchEvent& Event = HitchLog[(HitchLogHead - 1 - Row + HitchLog.Num() * 2) % HitchLog.Num()];
+      ImGui::TableNextColumn(); ImGui::Text("%.3f", Event.Time);
+      ImGui::TableNextColumn(); ImGui::Text("%llu", Event.FrameNumber);
+      ImGui::TableNextColumn(); ImGui::Text("%4.3f", Event.FrameTime);
+      ImGui::TableNextColumn(); ImGui::Text("%4.3f", Event.GameThreadTime);
+      ImGui::TableNextColumn(); ImGui::Text("%4.3f", Event.RenderThreadTime);
+      ImGui::TableNextColumn(); ImGui::Text("%4.3f", Event.GPUFrameTime);
+      ImGui::TableNextColumn(); ImGui::Text("%4.3f", Event.RHIThreadTime);
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(BoundNames[Event.BoundThread]);
+    }
+  }
+  ImGui::EndTable();
+}
+
+float FDFX_StatData::GetPacingTarget()
+{
+  if (PacingTargetMs > 0.f)
+    return PacingTargetMs;
+  if (PacingCapMs > 0.f)
+    return PacingCapMs;
+  return Percentiles.GetWindow(ChannelFrame).P50;
+}
+
+void FDFX_StatData::UpdatePacing()
+{
+  const float Interval = Frame.Raw[ChannelFrame];
+  const float Delta = LastFrameInterval > 0.f ? Interval - LastFrameInterval : 0.f;
+  const float Target = GetPacingTarget();
+
+  // A large delta of the opposite sign of the previous one: frames alternate long/short, 16/33 ms under VSync.
+  uint8 Flags = 0;
+  if (Target > 0.f && Interval > 1.5f * Target) {
+    Flags |= 1;
+    PacingMissedTotal++;
+  }
+  if (Target > 0.f && FMath::Abs(Delta) > 0.25f * Target && FMath::Abs(LastFrameDelta) > 0.25f * Target && Delta * LastFrameDelta < 0.f) {
+    Flags |= 2;
+  }
+
+  if (PacingCount == PacingWindow) {
+    const float OldDelta = PacingDeltas[PacingHead];
+    const uint8 OldFlags = PacingFlags[PacingHead];
+    PacingSum -= OldDelta;
+    PacingSumSq -= OldDelta * OldDelta;
+    PacingMissed -= OldFlags & 1;
+    PacingAlternating -= (OldFlags >> 1) & 1;
+  } else {
+    PacingCount++;
+  }
+  PacingDeltas[PacingHead] = Delta;
+  PacingFlags[PacingHead] = Flags;
+  PacingSum += Delta;
+  PacingSumSq += Delta * Delta;
+  PacingMissed += Flags & 1;
+  PacingAlternating += (Flags >> 1) & 1;
+  PacingHead = (PacingHead + 1) % PacingWindow;
+
+  LastFrameInterval = Interval;
+  LastFrameDelta = Delta;
+}
+
+void FDFX_StatData::DrawPacing()
+{
+  const double Mean = PacingCount > 0 ? PacingSum / PacingCount : 0.0;
+  const double Variance = PacingCount > 0 ? FMath::Max(0.0, PacingSumSq / PacingCount - Mean * Mean) : 0.0;
+  ImGui::Text("Target : %4.3f ms%s", GetPacingTarget(), PacingTargetMs > 0.f ? "" : (PacingCapMs > 0.f ? " (t.MaxFPS)" : " (P50)"));
+  ImGui::Text("Delta : %4.3f ms std dev | %4.3f ms variance (%i frames)", FMath::Sqrt(Variance), Variance, PacingCount);
+  ImGui::Text("Missed : %i (window) | %llu (session)", PacingMissed, PacingMissedTotal);
+  ImGui::Text("Alternating : %3.0f%%", PacingCount > 0 ? PacingAlternating * 100.f / PacingCount : 0.f);
+
+  if (PacingChannel == INDEX_NONE || History.Num() == 0)
+    return;
+  int32 Start = 0;
+  int32 Count = 0;
+  History.FindRange(static_cast<float>(ShownFrame.Time - HistoryBaseTime - pwFrame.History), Start, Count);
+  if (ImPlot::BeginPlot("##PacingPlot", ImVec2(-1, ImGui::GetTextLineHeight() * 8), plot_flags | ImPlotFlags_NoLegend)) {
+    ImPlot::SetupAxes("", "", axis_flags, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupAxisLimits(ImAxis_X1, ShownFrame.Time - HistoryBaseTime - pwFrame.History, ShownFrame.Time - HistoryBaseTime, ImGuiCond_Always);
+    ImPlot::PlotLine("Frame Delta", History.GetTimes() + Start, History.Get(PacingChannel) + Start, Count);
+    ImPlot::EndPlot();
+  }
+}
+
+#if STATS
+// Stats thread side of the stat channels, in the order they were bound, and the channel of every stat name met so far.
+static TArray<FName> StatThreadChannels;
+static TMap<FName, int32> StatThreadResolved;
+static TArray<FStatMessage> StatThreadMessages;
+static FDelegateHandle StatThreadHandle;
+static uint32 StatThreadUnresolved = 0;
+
+void FDFX_StatData::OnStatsNewFrame(int64 StatsFrame)
+{
+  FStatsThreadState& Stats = FStatsThreadState::GetLocalState();
+  FName Name;
+  while (PendingStatChannels.Dequeue(Name)) {
+    StatThreadUnresolved |= 1u << StatThreadChannels.Num();
+    StatThreadChannels.Add(Name);
+    StatThreadResolved.Reset();
+  }
+  // A stat is only known once its module declared it, unresolved names are looked up again every frame.
+  for (int32 i = 0; StatThreadUnresolved != 0 && i < StatThreadChannels.Num(); i++) {
+    if ((StatThreadUnresolved & (1u << i)) == 0)
+      continue;
+    if (const FStatMessage* LongName = Stats.ShortNameToLongName.Find(StatThreadChannels[i])) {
+      StatThreadUnresolved &= ~(1u << i);
+      if (!PendingStatGroups.Enqueue(LongName->NameAndInfo.GetGroupName())) {
+        UE_LOG(LogDFoundryFX, Warning, TEXT("StatData: Too many pending stat groups, enable the group of %s manually."), *StatThreadChannels[i].ToString());
+      }
+    }
+  }
+  if (StatThreadChannels.Num() == 0 || !Stats.IsFrameValid(StatsFrame))
+    return;
+
+  StatThreadMessages.Reset();
+  Stats.GetInclusiveAggregateStackStats(StatsFrame, StatThreadMessages);
+  FStatChannelValues Values;
+  FMemory::Memzero(Values);
+  Values.Unresolved = StatThreadUnresolved;
+  for (const FStatMessage& Message : StatThreadMessages) {
+    const FName RawName = Message.NameAndInfo.GetRawName();
+    const int32* Channel = StatThreadResolved.Find(RawName);
+    if (!Channel) {
+      Channel = &StatThreadResolved.Add(RawName, StatThreadChannels.IndexOfByKey(Message.NameAndInfo.GetShortName()));
+    }
+    if (*Channel == INDEX_NONE)
+      continue;
+
+    if (Message.NameAndInfo.GetFlag(EStatMetaFlags::IsPackedCCAndDuration)) {
+      Values.Values[*Channel] += FPlatformTime::ToMilliseconds(Message.GetValue_Duration());
+    } else if (Message.NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_double) {
+      Values.Values[*Channel] += static_cast<float>(Message.GetValue_double());
+    } else if (Message.NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_int64) {
+      Values.Values[*Channel] += static_cast<float>(Message.GetValue_int64());
+    }
+  }
+  StatChannelValues.Write(Values);
+}
+#endif
+
+void FDFX_StatData::BindStatChannel(const FString& StatName)
+{
+  if (!PendingStatBinds.Enqueue(FName(*StatName))) {
+    UE_LOG(LogDFoundryFX, Warning, TEXT("StatData: Too many pending stat channels, %s is not bound."), *StatName);
+  }
+}
+
+void FDFX_StatData::UnbindStatChannels()
+{
+#if STATS
+  if (!bStatChannelsSubscribed)
+    return;
+  bStatChannelsSubscribed = false;
+  FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(FSimpleDelegateGraphTask::FDelegate::CreateLambda([]()
+    {
+      FStatsThreadState::GetLocalState().NewFrameDelegate.Remove(StatThreadHandle);
+      StatsMasterEnableSubtract();
+    }), TStatId(), nullptr, FPlatformProcess::SupportsMultithreading() ? ENamedThreads::StatsThread : ENamedThreads::GameThread);
+#endif
+}
+
+void FDFX_StatData::UpdateStatChannels()
+{
+  static const ImVec4 Colors[] = {
+    ImVec4(0.90, 0.62, 0.00, 1), ImVec4(0.34, 0.71, 0.91, 1), ImVec4(0.00, 0.62, 0.45, 1), ImVec4(0.80, 0.47, 0.65, 1)
+  };
+
+  FName Name;
+  while (PendingStatBinds.Dequeue(Name)) {
+    const FString StatName = Name.ToString();
+    if (StatChannels.ContainsByPredicate([&StatName](const FStatChannel& Channel) { return Channel.Name == StatName; }))
+      continue;
+    if (StatChannels.Num() == MaxStatChannels) {
+      UE_LOG(LogDFoundryFX, Warning, TEXT("StatData: %i stat channels already bound, %s is not."), MaxStatChannels, *StatName);
+      continue;
+    }
+#if STATS
+    if (!bStatChannelsSubscribed) {
+      bStatChannelsSubscribed = true;
+      FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(FSimpleDelegateGraphTask::FDelegate::CreateLambda([]()
+        {
+          StatsMasterEnableAdd();
+          StatThreadHandle = FStatsThreadState::GetLocalState().NewFrameDelegate.AddStatic(&OnStatsNewFrame);
+        }), TStatId(), nullptr, FPlatformProcess::SupportsMultithreading() ? ENamedThreads::StatsThread : ENamedThreads::GameThread);
+    }
+#endif
+    StatChannels.Add({ StatName, RegisterHistoryChannel(StatName), Colors[StatChannels.Num() % UE_ARRAY_COUNT(Colors)] });
+    PendingStatChannels.Enqueue(Name);
+    UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Stat %s bound to history column %i."), *StatName, StatChannels.Last().Column);
+  }
+
+  if (StatChannels.Num() == 0)
+    return;
+  const FStatChannelValues Values = StatChannelValues.Read();
+  for (int32 i = 0; i < StatChannels.Num(); i++) {
+    History.Set(StatChannels[i].Column, Values.Values[i]);
+  }
+}
+
+void FDFX_StatData::PlotStatChannels(const FPlotWindow& Window)
+{
+  if (Window.StatChannels.Num() == 0 || History.Num() == 0)
+    return;
+
+  // Only the raw history has a column per registered channel, longer windows are cut to it.
+  int32 Start = 0;
+  int32 Count = 0;
+  History.FindRange(static_cast<float>(ShownFrame.Time - HistoryBaseTime - FMath::Min(Window.History, StatHistoryMax)), Start, Count);
+  for (const int32 Index : Window.StatChannels) {
+    const FStatChannel& Channel = StatChannels[Index];
+    ImPlot::PushStyleColor(ImPlotCol_Line, Channel.Color);
+    ImPlot::PlotLine(TCHAR_TO_ANSI(*Channel.Name), History.GetTimes() + Start, History.Get(Channel.Column) + Start, Count);
+    ImPlot::PopStyleColor();
+  }
+}
+
+int32 FDFX_StatData::RegisterHistoryChannel(const FString& Name)
+{
+  HistoryChannelNames.Add(Name);
+  return History.AddColumn();
+}
+
+void FDFX_StatData::RebaseHistory(double NewBaseTime)
+{
+  const float Delta = static_cast<float>(NewBaseTime - HistoryBaseTime);
+  HistoryBaseTime = NewBaseTime;
+  History.Rebase(Delta);
+  for (FHistoryLevel& Level : HistoryLevels) {
+    Level.Ring.Rebase(Delta);
+  }
+}
+
+void FDFX_StatData::FitHistory()
+{
+  if (HistorySampleInterval <= 0)
+    return;
+
+  // Enough for the longest window at the observed sample rate plus 25% headroom. Grow as soon as it is exceeded,
+  // shrink only below a quarter of the capacity, so a wobbling frame rate never reallocates.
+  const int Required = FMath::Clamp(FMath::CeilToInt(FMath::Min(StatHistoryGlobal, static_cast<float>(StatHistoryMax)) / HistorySampleInterval * 1.25), HistoryMinSize, HistoryMaxSize);
+  const int Capacity = History.GetCapacity();
+  if (Required <= Capacity && Required >= Capacity / 4)
+    return;
+
+  ResizeHistory(FMath::Min(static_cast<int>(FMath::RoundUpToPowerOfTwo(Required)), HistoryMaxSize));
+}
+
+void FDFX_StatData::ResizeHistory(int NewCapacity)
+{
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: History resized from %d to %d samples (%.1f s at %.0f Hz)."),
+    History.GetCapacity(), NewCapacity, StatHistoryGlobal, 1.0 / HistorySampleInterval);
+  History.Resize(NewCapacity);
+}
+
+void FDFX_StatData::FHistoryBucket::Merge(const FHistoryBucket& Other)
+{
+  if (Count == 0) {
+    *this = Other;
+    return;
+  }
+  Count += Other.Count;
+  for (int i = 0; i < ChannelNum; i++) {
+    Min[i] = FMath::Min(Min[i], Other.Min[i]);
+    Max[i] = FMath::Max(Max[i], Other.Max[i]);
+    Sum[i] += Other.Sum[i];
+  }
+}
+
+FDFX_StatData::FHistoryLevel::FHistoryLevel(double InBucketSeconds, int InCapacity)
+  : BucketSeconds(InBucketSeconds)
+  , Ring(InCapacity, 1 + ChannelNum * 3)
+{
+}
+
+bool FDFX_StatData::FHistoryLevel::Add(double InTime, const FHistoryBucket& Sample)
+{
+  bool bClosed = false;
+  if (InTime >= BucketEnd) {
+    if (Bucket.Count > 0) {
+      ClosedTime = BucketEnd - BucketSeconds * 0.5;
+      Ring.Set(0, static_cast<float>(Bucket.Count));
+      for (int i = 0; i < ChannelNum; i++) {
+        Ring.Set(MinColumn(i), static_cast<float>(Bucket.Min[i]));
+        Ring.Set(MaxColumn(i), static_cast<float>(Bucket.Max[i]));
+        Ring.Set(MeanColumn(i), static_cast<float>(Bucket.Sum[i] / Bucket.Count));
+      }
+      Ring.Add(static_cast<float>(ClosedTime - HistoryBaseTime));
+      Bucket.Count = 0;
+      bClosed = true;
+    }
+    BucketEnd = (FMath::FloorToDouble(InTime / BucketSeconds) + 1.0) * BucketSeconds;
+  }
+  Bucket.Merge(Sample);
+  return bClosed;
+}
+
+void FDFX_StatData::FHistoryLevel::Erase()
+{
+  BucketEnd = 0;
+  Bucket.Count = 0;
+  Ring.Erase();
+}
+
+void FDFX_StatData::AddHistoryLevels(double InTime, const FHistoryBucket& Sample)
+{
+  FHistoryLevel& Fine = HistoryLevels[0];
+  if (!Fine.Add(InTime, Sample))
+    return;
+
+  // Forward the bucket level 0 just closed.
+  FHistoryBucket Closed;
+  Closed.Count = Fine.Ring.Last(0);
+  for (int i = 0; i < ChannelNum; i++) {
+    Closed.Min[i] = Fine.Ring.Last(FHistoryLevel::MinColumn(i));
+    Closed.Max[i] = Fine.Ring.Last(FHistoryLevel::MaxColumn(i));
+    Closed.Sum[i] = Fine.Ring.Last(FHistoryLevel::MeanColumn(i)) * Closed.Count;
+  }
+  HistoryLevels[1].Add(Fine.ClosedTime, Closed);
+}
+
+void FDFX_StatData::PlotHistory(const char* Label, EHistoryChannel Channel, double Window, ImPlotLineFlags LineFlags, ImPlotShadedFlags ShadeFlags)
+{
+  const float MinTime = static_cast<float>(ShownFrame.Time - HistoryBaseTime - Window);
+  int32 Start = 0;
+  int32 Count = 0;
+  if (Window <= StatHistoryMax) {
+    History.FindRange(MinTime, Start, Count);
+    ImPlot::PlotLine(Label, History.GetTimes() + Start, History.Get(Channel) + Start, Count, LineFlags);
+    ImPlot::PlotShaded(Label, History.GetTimes() + Start, History.Get(Channel) + Start, Count, -INFINITY, ShadeFlags);
+    return;
+  }
+
+  // Pick the level by span so the point count stays in the same range whatever the window.
+  const FHistoryLevel& Level = HistoryLevels[Window <= 600.0 ? 0 : 1];
+  Level.Ring.FindRange(MinTime, Start, Count);
+  const float* Times = Level.Ring.GetTimes() + Start;
+  ImPlot::PlotLine(Label, Times, Level.Ring.Get(FHistoryLevel::MeanColumn(Channel)) + Start, Count, LineFlags);
+  ImPlot::PlotShaded(Label, Times, Level.Ring.Get(FHistoryLevel::MinColumn(Channel)) + Start, Level.Ring.Get(FHistoryLevel::MaxColumn(Channel)) + Start, Count, ShadeFlags);
 }
 
 void FDFX_StatData::LoadThreadPlot()
@@ -122,7 +857,7 @@ void FDFX_StatData::LoadThreadPlot()
   ImPlot::PushStyleColor(ImPlotCol_PlotBg, pwThread.PlotBackgroundColor);
   ImPlot::BeginPlot("THREADS (MS)", ImVec2(-1, -1), plot_flags | ImPlotFlags_NoLegend);
   ImPlot::SetupAxes("Threads", "", axis_flags, ImPlotAxisFlags_Opposite | ImPlotAxisFlags_NoLabel);
-  ImPlot::SetupAxisLimits(ImAxis_X1, m_CurrentTime - pwThread.History, m_CurrentTime, ImGuiCond_Always);
+  ImPlot::SetupAxisLimits(ImAxis_X1, ShownFrame.Time - HistoryBaseTime - pwThread.History, ShownFrame.Time - HistoryBaseTime, ImGuiCond_Always);
   ImPlot::SetupAxisLimits(ImAxis_Y1, pwThread.Range.x, pwThread.Range.y, ImGuiCond_Always);
   ImPlot::SetupFinish();
   ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, pwThread.PlotStyleFillAlpha);
@@ -133,111 +868,105 @@ void FDFX_StatData::LoadThreadPlot()
   ThreadPlotOrder.SetNumZeroed(7);
 
   if (bPlotsSort) {
-    ThreadPlotOrder[0] = m_GameThreadTime;
-    ThreadPlotOrder[1] = m_RenderThreadTime;
-    ThreadPlotOrder[2] = m_GPUFrameTime;
-    ThreadPlotOrder[3] = m_RHIThreadTime;
-    ThreadPlotOrder[4] = m_SwapBufferTime;
-    ThreadPlotOrder[5] = m_InputLatencyTime;
-    ThreadPlotOrder[6] = m_ImGuiThreadTime;
+    ThreadPlotOrder[0] = ShownFrame.GameThreadTime;
+    ThreadPlotOrder[1] = ShownFrame.RenderThreadTime;
+    ThreadPlotOrder[2] = ShownFrame.GPUFrameTime;
+    ThreadPlotOrder[3] = ShownFrame.RHIThreadTime;
+    ThreadPlotOrder[4] = ShownFrame.SwapBufferTime;
+    ThreadPlotOrder[5] = ShownFrame.InputLatencyTime;
+    ThreadPlotOrder[6] = ShownFrame.ImGuiThreadTime;
     ThreadPlotOrder.Sort();
   }
   else {
-    ThreadPlotOrder[0] = m_ImGuiThreadTime;
-    ThreadPlotOrder[1] = m_InputLatencyTime;
-    ThreadPlotOrder[2] = m_SwapBufferTime;
-    ThreadPlotOrder[3] = m_RHIThreadTime;
-    ThreadPlotOrder[4] = m_GPUFrameTime;
-    ThreadPlotOrder[5] = m_RenderThreadTime;
-    ThreadPlotOrder[6] = m_GameThreadTime;
+    ThreadPlotOrder[0] = ShownFrame.ImGuiThreadTime;
+    ThreadPlotOrder[1] = ShownFrame.InputLatencyTime;
+    ThreadPlotOrder[2] = ShownFrame.SwapBufferTime;
+    ThreadPlotOrder[3] = ShownFrame.RHIThreadTime;
+    ThreadPlotOrder[4] = ShownFrame.GPUFrameTime;
+    ThreadPlotOrder[5] = ShownFrame.RenderThreadTime;
+    ThreadPlotOrder[6] = ShownFrame.GameThreadTime;
   }
 
   for (int i = 6; i >= 0; --i)
   {
-    if (ThreadPlotOrder[i] == m_GameThreadTime && !ThreadDrawOrder[0]) {
+    if (ThreadPlotOrder[i] == ShownFrame.GameThreadTime && !ThreadDrawOrder[0]) {
       if (pwThreadColor[0].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[0].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[0].PlotShadeColor);
-        ImPlot::PlotLine("Game", &HistoryTime.Data[0], &GameThreadTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("Game", &HistoryTime.Data[0], &GameThreadTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("Game", ChannelGame, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[0] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_RenderThreadTime && !ThreadDrawOrder[1]) {
+    if (ThreadPlotOrder[i] == ShownFrame.RenderThreadTime && !ThreadDrawOrder[1]) {
       if (pwThreadColor[1].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[1].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[1].PlotShadeColor);
-        ImPlot::PlotLine("Render", &HistoryTime.Data[0], &RenderThreadTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("Render", &HistoryTime.Data[0], &RenderThreadTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("Render", ChannelRender, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[1] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_GPUFrameTime && !ThreadDrawOrder[2]) {
+    if (ThreadPlotOrder[i] == ShownFrame.GPUFrameTime && !ThreadDrawOrder[2]) {
       if (pwThreadColor[2].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[2].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[2].PlotShadeColor);
-        ImPlot::PlotLine("GPU", &HistoryTime.Data[0], &GPUFrameTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("GPU", &HistoryTime.Data[0], &GPUFrameTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("GPU", ChannelGPU, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[2] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_RHIThreadTime && !ThreadDrawOrder[3]) {
+    if (ThreadPlotOrder[i] == ShownFrame.RHIThreadTime && !ThreadDrawOrder[3]) {
       if (pwThreadColor[3].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[3].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[3].PlotShadeColor);
-        ImPlot::PlotLine("RHI", &HistoryTime.Data[0], &RHIThreadTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("RHI", &HistoryTime.Data[0], &RHIThreadTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("RHI", ChannelRHI, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[3] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_SwapBufferTime && !ThreadDrawOrder[4]) {
+    if (ThreadPlotOrder[i] == ShownFrame.SwapBufferTime && !ThreadDrawOrder[4]) {
       if (pwThreadColor[4].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[4].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[4].PlotShadeColor);
-        ImPlot::PlotLine("Swap", &HistoryTime.Data[0], &SwapBufferTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("Swap", &HistoryTime.Data[0], &SwapBufferTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("Swap", ChannelSwap, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[4] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_InputLatencyTime && !ThreadDrawOrder[5]) {
+    if (ThreadPlotOrder[i] == ShownFrame.InputLatencyTime && !ThreadDrawOrder[5]) {
       if (pwThreadColor[5].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[5].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[5].PlotShadeColor);
-        ImPlot::PlotLine("Input", &HistoryTime.Data[0], &InputLatencyTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("Input", &HistoryTime.Data[0], &InputLatencyTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("Input", ChannelInput, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[5] = true;
       continue;
     }
 
-    if (ThreadPlotOrder[i] == m_ImGuiThreadTime && !ThreadDrawOrder[6]) {
+    if (ThreadPlotOrder[i] == ShownFrame.ImGuiThreadTime && !ThreadDrawOrder[6]) {
       if (pwThreadColor[6].bShowFramePlot) {
         ImPlot::PushStyleColor(ImPlotCol_Line, pwThreadColor[6].PlotLineColor);
         ImPlot::PushStyleColor(ImPlotCol_Fill, pwThreadColor[6].PlotShadeColor);
-        ImPlot::PlotLine("ImGui", &HistoryTime.Data[0], &ImGuiThreadTime.Data[0], HistoryTime.Data.size(), line_flags, HistoryTime.Offset, sizeof(double));
-        ImPlot::PlotShaded("ImGui", &HistoryTime.Data[0], &ImGuiThreadTime.Data[0], HistoryTime.Data.size(), -INFINITY, shade_flags, HistoryTime.Offset, sizeof(double));
+        PlotHistory("ImGui", ChannelImGui, pwThread.History, line_flags, shade_flags);
         ImPlot::PopStyleColor(2);
       }
       ThreadDrawOrder[6] = true;
       continue;
     }
   }
+  PlotStatChannels(pwThread);
 
   double MarkerLine = pwThread.MarkerLine;
   ImPlot::DragLineY(0, &MarkerLine, ImVec4(0.0, 0.25, 0.0, 1.0), pwThread.MarkerThick, drag_flags); //pwThread.MarkerColor
@@ -262,62 +991,77 @@ void FDFX_StatData::LoadThreadPlot()
     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoFocusOnAppearing |
     ImGuiWindowFlags_NoBringToFrontOnFocus); //window_flags
 
-  ImGui::BeginTable("##tblThreadLegend", 2);
+  ImGui::BeginTable("##tblThreadLegend", 3);
   if (pwThreadColor[0].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(0);
     ImGui::TextColored(pwThreadColor[0].PlotShadeColor, "_ Game");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_GameThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.GameThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelGame).P99);
   }
   if (pwThreadColor[1].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(1);
     ImGui::TextColored(pwThreadColor[1].PlotShadeColor, "_ Render");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_RenderThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.RenderThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelRender).P99);
   }
   if (pwThreadColor[2].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(2);
     ImGui::TextColored(pwThreadColor[2].PlotShadeColor, "_ GPU");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_GPUFrameTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.GPUFrameTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelGPU).P99);
   }
   if (pwThreadColor[3].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(3);
     ImGui::TextColored(pwThreadColor[3].PlotShadeColor, "_ RHI");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_RHIThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.RHIThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelRHI).P99);
   }
   if (pwThreadColor[4].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(4);
     ImGui::TextColored(pwThreadColor[4].PlotShadeColor, "_ Swap");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_SwapBufferTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.SwapBufferTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelSwap).P99);
   }
   if (pwThreadColor[5].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(5);
     ImGui::TextColored(pwThreadColor[5].PlotShadeColor, "_ Input");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_InputLatencyTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.InputLatencyTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelInput).P99);
   }
   if (pwThreadColor[6].bShowFramePlot) {
     ImGui::TableNextColumn();
     FDFX_StatData::ThreadMarker(6);
     ImGui::TextColored(pwThreadColor[6].PlotShadeColor, "_ ImGui");
-    ImGui::TableNextColumn(); ImGui::Text("%4.3f", m_ImGuiThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", ShownFrame.ImGuiThreadTime);
+    ImGui::TableNextColumn(); ImGui::Text(" p99 %4.3f", Percentiles.GetWindow(ChannelImGui).P99);
+  }
+  for (const int32 Index : pwThread.StatChannels) {
+    const FStatChannel& Channel = StatChannels[Index];
+    ImGui::TableNextColumn(); ImGui::TextColored(Channel.Color, "_ %s", TCHAR_TO_ANSI(*Channel.Name));
+    ImGui::TableNextColumn(); ImGui::Text("%4.3f", History.Num() > 0 ? History.Last(Channel.Column) : 0.f);
+    ImGui::TableNextColumn();
   }
 
-  int32 NumDrawCalls = GNumDrawCallsRHI[0];
   ImGui::TableNextColumn(); ImGui::Text("Draws");
-  ImGui::TableNextColumn(); ImGui::Text("%i", NumDrawCalls);
+  ImGui::TableNextColumn(); ImGui::Text("%u", ShownFrame.DrawCalls);
+  ImGui::TableNextColumn();
   ImGui::TableNextColumn(); ImGui::Text("Triangles");
-  int32 NumPrimitives = GNumPrimitivesDrawnRHI[0];
+  const uint32 NumPrimitives = ShownFrame.Primitives;
   if (NumPrimitives < 10000) {
-    ImGui::TableNextColumn(); ImGui::Text("%i", NumPrimitives);
+    ImGui::TableNextColumn(); ImGui::Text("%u", NumPrimitives);
   } else {
     ImGui::TableNextColumn(); ImGui::Text("%.1f K", NumPrimitives / 1000.f);
   }
+  ImGui::TableNextColumn();
 
   ImGui::EndTable();
+  DrawBoundBar(ImGui::GetItemRectSize().x);
   ImGui::End();
   ImGui::PopStyleVar(4);
   ImGui::BringWindowToDisplayFront(ImGui::FindWindowByName("##ThreadsLegendWin"));
@@ -342,14 +1086,14 @@ void FDFX_StatData::LoadFramePlot()
   ImPlot::PushStyleColor(ImPlotCol_PlotBg, pwFrame.PlotBackgroundColor);
   ImPlot::BeginPlot("FRAME-TIME (MS)", ImVec2(-1, -1), plot_flags | ImPlotFlags_NoLegend);
   ImPlot::SetupAxes("", "", axis_flags, ImPlotAxisFlags_Opposite | ImPlotAxisFlags_NoLabel | ImPlotAxisFlags_Invert);
-  ImPlot::SetupAxisLimits(ImAxis_X1, m_CurrentTime - pwFrame.History, m_CurrentTime, ImGuiCond_Always);
+  ImPlot::SetupAxisLimits(ImAxis_X1, ShownFrame.Time - HistoryBaseTime - pwFrame.History, ShownFrame.Time - HistoryBaseTime, ImGuiCond_Always);
   ImPlot::SetupAxisLimits(ImAxis_Y1, pwFrame.Range.x, pwFrame.Range.y, ImGuiCond_Always);
   ImPlot::SetupFinish();
   ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, pwFrame.PlotStyleFillAlpha);
   ImPlot::PushStyleColor(ImPlotCol_Line, pwFrame.PlotLineColor);
   ImPlot::PushStyleColor(ImPlotCol_Fill, pwFrame.PlotShadeColor);
-  ImPlot::PlotLine("##Frame", &HistoryTime.Data[0], &FrameTime.Data[0], HistoryTime.Data.size(), 0, HistoryTime.Offset, sizeof(double));
-  ImPlot::PlotShaded("##Frame", &HistoryTime.Data[0], &FrameTime.Data[0], HistoryTime.Data.size(), -INFINITY, 0, HistoryTime.Offset, sizeof(double));
+  PlotHistory("##Frame", ChannelFrame, pwFrame.History, 0, 0);
+  PlotStatChannels(pwFrame);
   double MarkerLine = pwFrame.MarkerLine;
   ImPlot::DragLineY(0, &MarkerLine, ImVec4(0.0, 0.25, 0.0, 1.0), pwFrame.MarkerThick, drag_flags);
   ImPlot::PopStyleColor(2);
@@ -380,14 +1124,13 @@ void FDFX_StatData::LoadFPSPlot()
   ImPlot::PushStyleColor(ImPlotCol_PlotBg, pwFPS.PlotBackgroundColor);
   ImPlot::BeginPlot("FRAME-RATE (FPS)", ImVec2(-1, -1), plot_flags | ImPlotFlags_NoLegend);
   ImPlot::SetupAxes("", "", axis_flags, ImPlotAxisFlags_Opposite | ImPlotAxisFlags_NoLabel);
-  ImPlot::SetupAxisLimits(ImAxis_X1, m_CurrentTime - pwFrame.History, m_CurrentTime, ImGuiCond_Always);
+  ImPlot::SetupAxisLimits(ImAxis_X1, ShownFrame.Time - HistoryBaseTime - pwFrame.History, ShownFrame.Time - HistoryBaseTime, ImGuiCond_Always);
   ImPlot::SetupAxisLimits(ImAxis_Y1, pwFPS.Range.x, pwFPS.Range.y, ImGuiCond_Always);
   ImPlot::SetupFinish();
   ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, pwFPS.PlotStyleFillAlpha);
   ImPlot::PushStyleColor(ImPlotCol_Line, pwFPS.PlotLineColor);
   ImPlot::PushStyleColor(ImPlotCol_Fill, pwFPS.PlotShadeColor);
-  ImPlot::PlotLine("##FPS", &HistoryTime.Data[0], &FramesPerSecond.Data[0], HistoryTime.Data.size(), 0, HistoryTime.Offset, sizeof(double));
-  ImPlot::PlotShaded("##FPS", &HistoryTime.Data[0], &FramesPerSecond.Data[0], HistoryTime.Data.size(), -INFINITY, 0, HistoryTime.Offset, sizeof(double));
+  PlotHistory("##FPS", ChannelFPS, pwFrame.History, 0, 0);
   double MarkerLine = pwFPS.MarkerLine;
   ImPlot::DragLineY(0, &MarkerLine, ImVec4(0.0, 0.25, 0.0, 1.0), pwFPS.MarkerThick, drag_flags);
   ImPlot::PopStyleColor(2);
@@ -402,7 +1145,6 @@ void FDFX_StatData::LoadFPSPlot()
 
 void FDFX_StatData::MainWindow()
 {
-  APlayerController* PC = m_Viewport->GetWorld()->GetFirstPlayerController();
   constexpr char WindowTitle[] = "Debug menu";
   ImGui::Begin(WindowTitle, nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
 
@@ -441,15 +1183,18 @@ void FDFX_StatData::MainWindow()
 
     if (ImGui::BeginTabItem("Engine"))
     {
-      Tab_Engine();
+      if (!DrawDegradedTab())
+        Tab_Engine();
     }
     if (ImGui::BeginTabItem("Shaders"))
     {
-      Tab_Shaders();
+      if (!DrawDegradedTab())
+        Tab_Shaders();
     }
     if (ImGui::BeginTabItem("STAT"))
     {
-      Tab_STAT();
+      if (!DrawDegradedTab())
+        Tab_STAT();
     }
     if (ImGui::BeginTabItem("Settings"))
     {
@@ -475,26 +1220,35 @@ void FDFX_StatData::MainWindow()
   ImGui::End();
 }
 
+bool FDFX_StatData::DrawDegradedTab()
+{
+  if (OverlayDegradeLevel < DegradeMinimal)
+    return false;
+
+  ImGui::TextWrapped("Skipped, the overlay costs %.3f ms for a %.2f ms budget.", OverlayCostMs, OverlayBudgetMs.load(std::memory_order_relaxed));
+  ImGui::EndTabItem();
+  return true;
+}
+
 void FDFX_StatData::Tab_Engine()
 {
-  UWorld* uWorld = m_Viewport->GetWorld();
-  IConsoleManager& m_ConMng = IConsoleManager::Get();
+  const FEngineContext& Context = EngineContext;
 
   if (ImGui::CollapsingHeader("Viewport Settings")) {
     static int m_vwSize[2] = { static_cast<int>(ViewSize.X) , static_cast<int>(ViewSize.Y) };
-    static int m_MaxFPS = m_ConMng.FindConsoleVariable(TEXT("t.MaxFPS"))->GetInt();
-    static bool m_bVSync = m_ConMng.FindConsoleVariable(TEXT("r.VSync"))->GetBool();
-    static int m_ScrPct = m_ConMng.FindConsoleVariable(TEXT("r.ScreenPercentage"))->GetInt();
-    static int m_ResQlt = m_ConMng.FindConsoleVariable(TEXT("sg.ResolutionQuality"))->GetInt();
-    static int m_vwDist = m_ConMng.FindConsoleVariable(TEXT("r.ViewDistanceScale"))->GetInt();
-    static int m_PPQlt = m_ConMng.FindConsoleVariable(TEXT("sg.PostProcessQuality"))->GetInt();
-    static int m_ShdwQlt = m_ConMng.FindConsoleVariable(TEXT("sg.ShadowQuality"))->GetInt();
-    static int m_TexQlt = m_ConMng.FindConsoleVariable(TEXT("sg.TextureQuality"))->GetInt();
-    static int m_FXQlt = m_ConMng.FindConsoleVariable(TEXT("sg.EffectsQuality"))->GetInt();
-    static int m_DetMd = m_ConMng.FindConsoleVariable(TEXT("r.DetailMode"))->GetInt();
-    static int m_SKLOD = m_ConMng.FindConsoleVariable(TEXT("r.SkeletalMeshLODBias"))->GetInt();
-    static bool m_bFullscreen = m_Viewport->Viewport->IsFullscreen();
-    static bool m_bFullscreenExclusive = (m_ConMng.FindConsoleVariable(TEXT("r.FullscreenMode"))->GetInt() == 1? false : true);
+    static int m_MaxFPS = Context.MaxFPS;
+    static bool m_bVSync = Context.bVSync;
+    static int m_ScrPct = Context.ScreenPercentage;
+    static int m_ResQlt = Context.ResolutionQuality;
+    static int m_vwDist = Context.ViewDistanceScale;
+    static int m_PPQlt = Context.PostProcessQuality;
+    static int m_ShdwQlt = Context.ShadowQuality;
+    static int m_TexQlt = Context.TextureQuality;
+    static int m_FXQlt = Context.EffectsQuality;
+    static int m_DetMd = Context.DetailMode;
+    static int m_SKLOD = Context.SkeletalMeshLODBias;
+    static bool m_bFullscreen = Context.IsFullscreen;
+    static bool m_bFullscreenExclusive = (Context.FullscreenMode == 1? false : true);
 
     ImGui::BeginTable("##tblViewSettingsBase", 2, ImGuiTableFlags_SizingStretchProp);
     ImGui::TableNextColumn();
@@ -502,19 +1256,19 @@ void FDFX_StatData::Tab_Engine()
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS1")) {
       if (m_bFullscreen) {
-        m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%if"), m_vwSize[0], m_vwSize[1]));
+        ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%if"), m_vwSize[0], m_vwSize[1]));
       } else {
-        m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%iw"), m_vwSize[0], m_vwSize[1]));
+        ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%iw"), m_vwSize[0], m_vwSize[1]));
       }
     }
 
     ImGui::TableNextColumn();
     if (ImGui::Checkbox("Fullscreen", &m_bFullscreen)) {
-      if (m_bFullscreen != m_Viewport->Viewport->IsFullscreen()) {
+      if (m_bFullscreen != Context.IsFullscreen) {
         if (m_bFullscreen) {
-          m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%if"), m_vwSize[0], m_vwSize[1]));
+          ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%if"), m_vwSize[0], m_vwSize[1]));
         } else {
-          m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%iw"), m_vwSize[0], m_vwSize[1]));
+          ConsoleCommand(FString::Printf(TEXT("r.SetRes %ix%iw"), m_vwSize[0], m_vwSize[1]));
         }
       }
     }
@@ -522,12 +1276,12 @@ void FDFX_StatData::Tab_Engine()
 
     ImGui::TableNextColumn();
     if (ImGui::Checkbox("FullscreenExclusive", &m_bFullscreenExclusive)) {
-      if (m_bFullscreenExclusive != (m_ConMng.FindConsoleVariable(TEXT("r.FullscreenMode"))->GetInt() == 1 ? false : true)) {
+      if (m_bFullscreenExclusive != (Context.FullscreenMode == 1 ? false : true)) {
         if (m_bFullscreenExclusive) {
-          m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.FullscreenMode 2")));
+          ConsoleCommand(FString::Printf(TEXT("r.FullscreenMode 2")));
           m_bFullscreenExclusive = true;
         } else {
-          m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.FullscreenMode 1")));
+          ConsoleCommand(FString::Printf(TEXT("r.FullscreenMode 1")));
           m_bFullscreenExclusive = false;
         }
       }
@@ -536,11 +1290,11 @@ void FDFX_StatData::Tab_Engine()
 
     ImGui::TableNextColumn();
     if (ImGui::Checkbox("VSync", &m_bVSync)) {
-      if (m_bVSync != m_ConMng.FindConsoleVariable(TEXT("r.VSync"))->GetBool()) {
+      if (m_bVSync != Context.bVSync) {
         if (m_bVSync) {
-          m_Viewport->ConsoleCommand("r.VSync 1");
+          ConsoleCommand("r.VSync 1");
         } else {
-          m_Viewport->ConsoleCommand("r.VSync 0");
+          ConsoleCommand("r.VSync 0");
         }
       }
     }
@@ -550,52 +1304,52 @@ void FDFX_StatData::Tab_Engine()
     ImGui::InputInt("MaxFPS", &m_MaxFPS, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS2"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("t.MaxFPS %i"), m_MaxFPS));
+      ConsoleCommand(FString::Printf(TEXT("t.MaxFPS %i"), m_MaxFPS));
     ImGui::TableNextColumn();
     ImGui::InputInt("ScreenPercent", &m_ScrPct, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS3"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.ScreenPercentage %i"), m_ScrPct));
+      ConsoleCommand(FString::Printf(TEXT("r.ScreenPercentage %i"), m_ScrPct));
     ImGui::TableNextColumn();
     ImGui::InputInt("Res.Quality", &m_ResQlt, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS4"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("sg.ResolutionQuality %i"), m_ResQlt));
+      ConsoleCommand(FString::Printf(TEXT("sg.ResolutionQuality %i"), m_ResQlt));
     ImGui::TableNextColumn();
     ImGui::InputInt("ViewDistance", &m_vwDist, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS5"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.ViewDistanceScale %i"), m_vwDist));
+      ConsoleCommand(FString::Printf(TEXT("r.ViewDistanceScale %i"), m_vwDist));
     ImGui::TableNextColumn();
     ImGui::InputInt("PP Quality", &m_PPQlt, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS6"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("sg.PostProcessQuality %i"), m_PPQlt));
+      ConsoleCommand(FString::Printf(TEXT("sg.PostProcessQuality %i"), m_PPQlt));
     ImGui::TableNextColumn();
     ImGui::InputInt("Shadow Qual.", &m_ShdwQlt, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS7"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("sg.ShadowQuality %i"), m_ShdwQlt));
+      ConsoleCommand(FString::Printf(TEXT("sg.ShadowQuality %i"), m_ShdwQlt));
     ImGui::TableNextColumn();
     ImGui::InputInt("Texture Qual.", &m_TexQlt, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS8"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("sg.TextureQuality %i"), m_TexQlt));
+      ConsoleCommand(FString::Printf(TEXT("sg.TextureQuality %i"), m_TexQlt));
     ImGui::TableNextColumn();
     ImGui::InputInt("Effects Qual.", &m_FXQlt, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS9"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("sg.EffectsQuality %i"), m_FXQlt));
+      ConsoleCommand(FString::Printf(TEXT("sg.EffectsQuality %i"), m_FXQlt));
     ImGui::TableNextColumn();
     ImGui::InputInt("Detail Mode", &m_DetMd, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS10"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.DetailMode %i"), m_DetMd));
+      ConsoleCommand(FString::Printf(TEXT("r.DetailMode %i"), m_DetMd));
     ImGui::TableNextColumn();
     ImGui::InputInt("Skeletal LOD", &m_SKLOD, 1, 5); ImGui::SameLine();
     ImGui::TableNextColumn();
     if (ImGui::Button("Apply##btnVS11"))
-      m_Viewport->ConsoleCommand(FString::Printf(TEXT("r.SkeletalMeshLODBias %i"), m_SKLOD));
+      ConsoleCommand(FString::Printf(TEXT("r.SkeletalMeshLODBias %i"), m_SKLOD));
 
     ImGui::EndTable();
   }
@@ -614,71 +1368,71 @@ void FDFX_StatData::Tab_Engine()
 
   if (ImGui::CollapsingHeader("Viewport Context")) {
     ImGui::BeginDisabled();
-    InfoHelper("bIsPlayInEditorViewport", m_Viewport->bIsPlayInEditorViewport);
-    InfoHelper("GetDPIScale", m_Viewport->GetDPIScale());
-    InfoHelper("GetDPIDerivedResolutionFraction", m_Viewport->GetDPIDerivedResolutionFraction());
-    InfoHelper("IsCursorVisible", m_Viewport->Viewport->IsCursorVisible());
-    InfoHelper("IsForegroundWindow", m_Viewport->Viewport->IsForegroundWindow());
-    InfoHelper("IsExclusiveFullscreen", m_Viewport->Viewport->IsExclusiveFullscreen());
-    InfoHelper("IsFullscreen", m_Viewport->Viewport->IsFullscreen());
-    InfoHelper("IsGameRenderingEnabled", m_Viewport->Viewport->IsGameRenderingEnabled());
-    InfoHelper("IsHDRViewport", m_Viewport->Viewport->IsHDRViewport());
-    InfoHelper("IsKeyboardAvailable", m_Viewport->Viewport->IsKeyboardAvailable(0));
-    InfoHelper("IsMouseAvailable", m_Viewport->Viewport->IsMouseAvailable(0));
-    InfoHelper("IsPenActive", m_Viewport->Viewport->IsPenActive());
-    InfoHelper("IsPlayInEditorViewport", m_Viewport->Viewport->IsPlayInEditorViewport());
-    InfoHelper("IsSlateViewport", m_Viewport->Viewport->IsSlateViewport());
-    InfoHelper("IsSoftwareCursorVisible", m_Viewport->Viewport->IsSoftwareCursorVisible());
-    InfoHelper("IsStereoRenderingAllowed", m_Viewport->Viewport->IsStereoRenderingAllowed());
+    InfoHelper("bIsPlayInEditorViewport", EngineContext.bIsPlayInEditorViewport);
+    InfoHelper("GetDPIScale", EngineContext.GetDPIScale);
+    InfoHelper("GetDPIDerivedResolutionFraction", EngineContext.GetDPIDerivedResolutionFraction);
+    InfoHelper("IsCursorVisible", EngineContext.IsCursorVisible);
+    InfoHelper("IsForegroundWindow", EngineContext.IsForegroundWindow);
+    InfoHelper("IsExclusiveFullscreen", EngineContext.IsExclusiveFullscreen);
+    InfoHelper("IsFullscreen", EngineContext.IsFullscreen);
+    InfoHelper("IsGameRenderingEnabled", EngineContext.IsGameRenderingEnabled);
+    InfoHelper("IsHDRViewport", EngineContext.IsHDRViewport);
+    InfoHelper("IsKeyboardAvailable", EngineContext.IsKeyboardAvailable);
+    InfoHelper("IsMouseAvailable", EngineContext.IsMouseAvailable);
+    InfoHelper("IsPenActive", EngineContext.IsPenActive);
+    InfoHelper("IsPlayInEditorViewport", EngineContext.IsPlayInEditorViewport);
+    InfoHelper("IsSlateViewport", EngineContext.IsSlateViewport);
+    InfoHelper("IsSoftwareCursorVisible", EngineContext.IsSoftwareCursorVisible);
+    InfoHelper("IsStereoRenderingAllowed", EngineContext.IsStereoRenderingAllowed);
     ImGui::EndDisabled();
   }
 
   if (ImGui::CollapsingHeader("GEngine Context")) {
     ImGui::BeginDisabled();
 
-    InfoHelper("IsEditor", GEngine->IsEditor());
-    InfoHelper("IsAllowedFramerateSmoothing", GEngine->IsAllowedFramerateSmoothing());
-    InfoHelper("bForceDisableFrameRateSmoothing", GEngine->bForceDisableFrameRateSmoothing);
-    InfoHelper("bSmoothFrameRate", GEngine->bSmoothFrameRate);
-    InfoHelper("MinDesiredFrameRate", GEngine->MinDesiredFrameRate);
-    InfoHelper("bUseFixedFrameRate", GEngine->bUseFixedFrameRate);
-    InfoHelper("FixedFrameRate", GEngine->FixedFrameRate);
-    InfoHelper("bCanBlueprintsTickByDefault", GEngine->bCanBlueprintsTickByDefault);
-    InfoHelper("IsControllerIdUsingPlatformUserId", GEngine->IsControllerIdUsingPlatformUserId());
-    InfoHelper("IsStereoscopic3D", GEngine->IsStereoscopic3D(m_Viewport->Viewport));
-    InfoHelper("IsVanillaProduct", GEngine->IsVanillaProduct());
-    InfoHelper("HasMultipleLocalPlayers", GEngine->HasMultipleLocalPlayers(uWorld));
-
-    InfoHelper("AreEditorAnalyticsEnabled", GEngine->AreEditorAnalyticsEnabled());
-    InfoHelper("bAllowMultiThreadedAnimationUpdate", GEngine->bAllowMultiThreadedAnimationUpdate);
-    InfoHelper("bDisableAILogging", GEngine->bDisableAILogging);
-    InfoHelper("bEnableOnScreenDebugMessages", GEngine->bEnableOnScreenDebugMessages);
-    InfoHelper("bEnableOnScreenDebugMessagesDisplay", GEngine->bEnableOnScreenDebugMessagesDisplay);
-    InfoHelper("bEnableEditorPSysRealtimeLOD", GEngine->bEnableEditorPSysRealtimeLOD);
-    InfoHelper("bEnableVisualLogRecordingOnStart", GEngine->bEnableVisualLogRecordingOnStart);
-    InfoHelper("bGenerateDefaultTimecode", GEngine->bGenerateDefaultTimecode);
-    InfoHelper("bIsInitialized", GEngine->bIsInitialized);
-    InfoHelper("bLockReadOnlyLevels", GEngine->bLockReadOnlyLevels);
-    InfoHelper("bOptimizeAnimBlueprintMemberVariableAccess", GEngine->bOptimizeAnimBlueprintMemberVariableAccess);
-    InfoHelper("bPauseOnLossOfFocus", GEngine->bPauseOnLossOfFocus);
-    InfoHelper("bRenderLightMapDensityGrayscale", GEngine->bRenderLightMapDensityGrayscale);
-    InfoHelper("bShouldGenerateLowQualityLightmaps_DEPRECATED", GEngine->bShouldGenerateLowQualityLightmaps_DEPRECATED);
-    InfoHelper("BSPSelectionHighlightIntensity", GEngine->BSPSelectionHighlightIntensity);
-    InfoHelper("bStartedLoadMapMovie", GEngine->bStartedLoadMapMovie);
-    InfoHelper("bSubtitlesEnabled", GEngine->bSubtitlesEnabled);
-    InfoHelper("bSubtitlesForcedOff", GEngine->bSubtitlesForcedOff);
-    InfoHelper("bSuppressMapWarnings", GEngine->bSuppressMapWarnings);
-    InfoHelper("DisplayGamma", GEngine->DisplayGamma);
-    InfoHelper("IsAutosaving", GEngine->IsAutosaving());
-    InfoHelper("MaximumLoopIterationCount", GEngine->MaximumLoopIterationCount);
-    InfoHelper("MaxLightMapDensity", GEngine->MaxLightMapDensity);
-    InfoHelper("MaxOcclusionPixelsFraction", GEngine->MaxOcclusionPixelsFraction);
-    InfoHelper("MaxParticleResize", GEngine->MaxParticleResize);
-    InfoHelper("MaxParticleResizeWarn", GEngine->MaxParticleResizeWarn);
-    InfoHelper("MaxPixelShaderAdditiveComplexityCount", GEngine->MaxPixelShaderAdditiveComplexityCount);
+    InfoHelper("IsEditor", EngineContext.IsEditor);
+    InfoHelper("IsAllowedFramerateSmoothing", EngineContext.IsAllowedFramerateSmoothing);
+    InfoHelper("bForceDisableFrameRateSmoothing", EngineContext.bForceDisableFrameRateSmoothing);
+    InfoHelper("bSmoothFrameRate", EngineContext.bSmoothFrameRate);
+    InfoHelper("MinDesiredFrameRate", EngineContext.MinDesiredFrameRate);
+    InfoHelper("bUseFixedFrameRate", EngineContext.bUseFixedFrameRate);
+    InfoHelper("FixedFrameRate", EngineContext.FixedFrameRate);
+    InfoHelper("bCanBlueprintsTickByDefault", EngineContext.bCanBlueprintsTickByDefault);
+    InfoHelper("IsControllerIdUsingPlatformUserId", EngineContext.IsControllerIdUsingPlatformUserId);
+    InfoHelper("IsStereoscopic3D", EngineContext.IsStereoscopic3D);
+    InfoHelper("IsVanillaProduct", EngineContext.IsVanillaProduct);
+    InfoHelper("HasMultipleLocalPlayers", EngineContext.HasMultipleLocalPlayers);
+
+    InfoHelper("AreEditorAnalyticsEnabled", EngineContext.AreEditorAnalyticsEnabled);
+    InfoHelper("bAllowMultiThreadedAnimationUpdate", EngineContext.bAllowMultiThreadedAnimationUpdate);
+    InfoHelper("bDisableAILogging", EngineContext.bDisableAILogging);
+    InfoHelper("bEnableOnScreenDebugMessages", EngineContext.bEnableOnScreenDebugMessages);
+    InfoHelper("bEnableOnScreenDebugMessagesDisplay", EngineContext.bEnableOnScreenDebugMessagesDisplay);
+    InfoHelper("bEnableEditorPSysRealtimeLOD", EngineContext.bEnableEditorPSysRealtimeLOD);
+    InfoHelper("bEnableVisualLogRecordingOnStart", EngineContext.bEnableVisualLogRecordingOnStart);
+    InfoHelper("bGenerateDefaultTimecode", EngineContext.bGenerateDefaultTimecode);
+    InfoHelper("bIsInitialized", EngineContext.bIsInitialized);
+    InfoHelper("bLockReadOnlyLevels", EngineContext.bLockReadOnlyLevels);
+    InfoHelper("bOptimizeAnimBlueprintMemberVariableAccess", EngineContext.bOptimizeAnimBlueprintMemberVariableAccess);
+    InfoHelper("bPauseOnLossOfFocus", EngineContext.bPauseOnLossOfFocus);
+    InfoHelper("bRenderLightMapDensityGrayscale", EngineContext.bRenderLightMapDensityGrayscale);
+    InfoHelper("bShouldGenerateLowQualityLightmaps_DEPRECATED", EngineContext.bShouldGenerateLowQualityLightmaps_DEPRECATED);
+    InfoHelper("BSPSelectionHighlightIntensity", EngineContext.BSPSelectionHighlightIntensity);
+    InfoHelper("bStartedLoadMapMovie", EngineContext.bStartedLoadMapMovie);
+    InfoHelper("bSubtitlesEnabled", EngineContext.bSubtitlesEnabled);
+    InfoHelper("bSubtitlesForcedOff", EngineContext.bSubtitlesForcedOff);
+    InfoHelper("bSuppressMapWarnings", EngineContext.bSuppressMapWarnings);
+    InfoHelper("DisplayGamma", EngineContext.DisplayGamma);
+    InfoHelper("IsAutosaving", EngineContext.IsAutosaving);
+    InfoHelper("MaximumLoopIterationCount", EngineContext.MaximumLoopIterationCount);
+    InfoHelper("MaxLightMapDensity", EngineContext.MaxLightMapDensity);
+    InfoHelper("MaxOcclusionPixelsFraction", EngineContext.MaxOcclusionPixelsFraction);
+    InfoHelper("MaxParticleResize", EngineContext.MaxParticleResize);
+    InfoHelper("MaxParticleResizeWarn", EngineContext.MaxParticleResizeWarn);
+    InfoHelper("MaxPixelShaderAdditiveComplexityCount", EngineContext.MaxPixelShaderAdditiveComplexityCount);
     // InfoHelper("StreamingDistanceFactor", GEngine->StreamingDistanceFactor); // Deprecated in UE5.2
     //InfoHelper("UseSkeletalMeshMinLODPerQualityLevels", GEngine->UseSkeletalMeshMinLODPerQualityLevels);
-    InfoHelper("UseStaticMeshMinLODPerQualityLevels", GEngine->UseStaticMeshMinLODPerQualityLevels);
+    InfoHelper("UseStaticMeshMinLODPerQualityLevels", EngineContext.UseStaticMeshMinLODPerQualityLevels);
 
     ImGui::EndDisabled();
   }
@@ -897,7 +1651,7 @@ void FDFX_StatData::Tab_Shaders()
     ImGui::TableSetupColumn("Time (ms)");
     ImGui::TableSetupColumn("Count");
     ImGui::TableHeadersRow();
-    for (FShaderCompilerLog ShaderLog : ShaderCompilerLog)
+    for (const FShaderCompilerLog& ShaderLog : ShaderCompilerLog)
     {
       if (ShaderLog.Count == 0) 
         continue;
@@ -914,7 +1668,9 @@ void FDFX_StatData::Tab_Shaders()
           ImGui::Text("RT");
           break;
       }
-      ImGui::TableNextColumn(); ImGui::Text("%s", TCHAR_TO_ANSI(*ShaderLog.Hash.Left(40)));
+      char s_Hash[41];
+      HashToText(ShaderLog.Hash, s_Hash);
+      ImGui::TableNextColumn(); ImGui::Text("%s", s_Hash);
       ImGui::TableNextColumn(); ImGui::Text("%.5f", ShaderLog.Time);
       ImGui::TableNextColumn(); ImGui::Text("%i", ShaderLog.Count);
       TimeTotal += ShaderLog.Time;
@@ -924,16 +1680,18 @@ void FDFX_StatData::Tab_Shaders()
     HelpMarker("CS = ComputeShader, GS = GraphicsShader, RT = RayTracing."); ImGui::SameLine();
     ImGui::Text("Total Shaders : %i", ShaderTotal); ImGui::SameLine();
     ImGui::Text(" | Time : %.5f", TimeTotal);
+    if (DroppedShaderEvents.GetValue() > 0) {
+      ImGui::SameLine(); ImGui::Text(" | Dropped : %i", DroppedShaderEvents.GetValue());
+    }
   }
 
 
   if (ImGui::CollapsingHeader("r.ShaderPipelineCache Context")) {
-    IConsoleManager& m_ConMng = IConsoleManager::Get();
-    static bool m_Enabled = m_ConMng.FindConsoleVariable(TEXT("r.ShaderPipelineCache.Enabled"))->GetBool();
-    static int32 m_BatchSize = m_ConMng.FindConsoleVariable(TEXT("r.ShaderPipelineCache.BatchSize"))->GetInt();
-    static int32 m_BackgroundBatchSize = m_ConMng.FindConsoleVariable(TEXT("r.ShaderPipelineCache.BackgroundBatchSize"))->GetBool();
-    static bool m_LogPSO = m_ConMng.FindConsoleVariable(TEXT("r.ShaderPipelineCache.LogPSO"))->GetBool();
-    static bool m_SaveAfterPSOsLogged = m_ConMng.FindConsoleVariable(TEXT("r.ShaderPipelineCache.SaveAfterPSOsLogged"))->GetBool();
+    static bool m_Enabled = EngineContext.bPipelineCacheEnabled;
+    static int32 m_BatchSize = EngineContext.PipelineCacheBatchSize;
+    static int32 m_BackgroundBatchSize = EngineContext.PipelineCacheBackgroundBatchSize;
+    static bool m_LogPSO = EngineContext.bPipelineCacheLogPSO;
+    static bool m_SaveAfterPSOsLogged = EngineContext.bPipelineCacheSaveAfterPSOsLogged;
 
     ImGui::BeginDisabled();
     InfoHelper("Enabled", m_Enabled);
@@ -1025,10 +1783,6 @@ void FDFX_StatData::Tab_Shaders()
 
 void FDFX_StatData::Tab_STAT()
 {
-  for (auto& elem : aStatCmds) {
-    elem.Enable = m_Viewport->IsStatEnabled(elem.Command);
-  }
-
   if (ImGui::CollapsingHeader("Favorites")) {
     ImGui::BeginTable("##tblFavBase", 2, ImGuiTableFlags_SizingStretchProp);
     ImGui::TableNextColumn(); ImGui::TableNextColumn();
@@ -1088,16 +1842,16 @@ void FDFX_StatData::Tab_STAT()
   if (ImGui::CollapsingHeader("Capture")) {
     ImGui::Text("Starts a statistics capture, creating a new file in the Profiling directory.");
     if (ImGui::Button("StartFile")) {
-      m_Viewport->ConsoleCommand("Stat StartFile");;
+      ConsoleCommand("Stat StartFile");;
     }
     if (ImGui::Button("StopFile")) {
-      m_Viewport->ConsoleCommand("Stat StopFile");;
+      ConsoleCommand("Stat StopFile");;
     }
   }
 
   if (ImGui::CollapsingHeader("Extras")) {
     if (ImGui::Button("Stat Help")) {
-      m_Viewport->ConsoleCommand("Stat Help"); ImGui::SameLine();
+      ConsoleCommand("Stat Help"); ImGui::SameLine();
       FDFX_StatData::HelpMarker("List avaiable STAT commands in the OutputLog window.");
     }
   }
@@ -1113,7 +1867,7 @@ void FDFX_StatData::Tab_Settings()
   if (ImGui::CollapsingHeader("Graphs")) {
     ImGui::Checkbox("Display Graphs", &bShowPlots);
     ImGui::Text("History :"); ImGui::SameLine(); ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-    ImGui::SliderFloat("##HistoryGlobal", &StatHistoryGlobal, 0.1, 10, "%.1f s");
+    ImGui::SliderFloat("##HistoryGlobal", &StatHistoryGlobal, 0.1, StatHistoryLongMax, "%.1f s", ImGuiSliderFlags_Logarithmic);
 
     if (bShowPlots) {
       ImGui::Indent();
@@ -1121,7 +1875,7 @@ void FDFX_StatData::Tab_Settings()
         ImGui::Checkbox("Display Threads", &pwThread.bShowPlot);
         ImGui::Checkbox("Sort plot order", &bPlotsSort); ImGui::SameLine();
         FDFX_StatData::HelpMarker("Sort graphs order to display better colors but can cause flickering if two threads have similar values.");
-        ImGui::SliderFloat("History##1", &pwThread.History, 0.1, StatHistoryGlobal, "%.1f s");
+        ImGui::SliderFloat("History##1", &pwThread.History, 0.1, StatHistoryGlobal, "%.1f s", ImGuiSliderFlags_Logarithmic);
         ImGui::SliderFloat("Position X##1", &pwThread.Position.x, 0, ViewSize.X - 1, "%.0f px");
         ImGui::SliderFloat("Position Y##1", &pwThread.Position.y, 0, ViewSize.Y - 1, "%.0f px");
         ImGui::SliderFloat("Size X##1", &pwThread.Size.x, 0, ViewSize.X - 1, "%.0f px");
@@ -1172,7 +1926,7 @@ void FDFX_StatData::Tab_Settings()
       }
       if (ImGui::CollapsingHeader("Frame")) {
         ImGui::Checkbox("Display Frame", &pwFrame.bShowPlot);
-        ImGui::SliderFloat("History##2", &pwFrame.History, 0.1, StatHistoryGlobal, "%.1f s");
+        ImGui::SliderFloat("History##2", &pwFrame.History, 0.1, StatHistoryGlobal, "%.1f s", ImGuiSliderFlags_Logarithmic);
         ImGui::SliderFloat("Position X##2", &pwFrame.Position.x, 0, ViewSize.X - 1, "%.0f px");
         ImGui::SliderFloat("Position Y##2", &pwFrame.Position.y, 0, ViewSize.Y - 1, "%.0f px");
         ImGui::SliderFloat("Size X##2", &pwFrame.Size.x, 0, ViewSize.X - 1, "%.0f px");
@@ -1189,7 +1943,7 @@ void FDFX_StatData::Tab_Settings()
       }
       if (ImGui::CollapsingHeader("FPS")) {
         ImGui::Checkbox("Display FPS", &pwFPS.bShowPlot);
-        ImGui::SliderFloat("History##3", &pwFPS.History, 0.1, StatHistoryGlobal, "%.1f s");
+        ImGui::SliderFloat("History##3", &pwFPS.History, 0.1, StatHistoryGlobal, "%.1f s", ImGuiSliderFlags_Logarithmic);
         ImGui::SliderFloat("Position X##3", &pwFPS.Position.x, 0, ViewSize.X - 1, "%.0f px");
         ImGui::SliderFloat("Position Y##3", &pwFPS.Position.y, 0, ViewSize.Y - 1, "%.0f px");
         ImGui::SliderFloat("Size X##3", &pwFPS.Size.x, 0, ViewSize.X - 1, "%.0f px");
@@ -1204,6 +1958,59 @@ void FDFX_StatData::Tab_Settings()
         ImGui::SliderFloat("Marker Line##3", &pwFPS.MarkerLine, 1, 144, "%.3f");
         ImGui::SliderFloat("Marker Thickness##3", &pwFPS.MarkerThick, 1, 10, "%.0f");
       }
+      if (ImGui::CollapsingHeader("Histogram")) {
+        ImGui::Checkbox("Display Histogram", &pwHistogram.bShowPlot);
+        ImGui::Checkbox("Whole Session", &bHistogramSession);
+        ImGui::SameLine(); FDFX_StatData::HelpMarker("Frame time distribution of the whole session instead of the last 10 s. Budget lines at 120, 60 and 30 fps.");
+        ImGui::SliderFloat("Position X##4", &pwHistogram.Position.x, 0, ViewSize.X - 1, "%.0f px");
+        ImGui::SliderFloat("Position Y##4", &pwHistogram.Position.y, 0, ViewSize.Y - 1, "%.0f px");
+        ImGui::SliderFloat("Size X##4", &pwHistogram.Size.x, 0, ViewSize.X - 1, "%.0f px");
+        ImGui::SliderFloat("Size Y##4", &pwHistogram.Size.y, 0, ViewSize.Y - 1, "%.0f px");
+        ImGui::SliderFloat("Range Min##4", &pwHistogram.Range.x, 0.1, 100, "%.3f ms", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Range Max##4", &pwHistogram.Range.y, 1, 1000, "%.3f ms", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Share Max##4", &pwHistogram.MarkerLine, 1, 100, "%.0f %%");
+        ImGui::ColorEdit4("Background##4", &pwHistogram.BackgroundColor.x);
+        ImGui::SliderFloat("Plot Alpha##4", &pwHistogram.PlotStyleFillAlpha, 0, 1, "%.2f");
+        ImGui::ColorEdit4("Plot Background##4", &pwHistogram.PlotBackgroundColor.x);
+        ImGui::ColorEdit4("Plot Line##4", &pwHistogram.PlotLineColor.x);
+        ImGui::ColorEdit4("Plot Shade##4", &pwHistogram.PlotShadeColor.x);
+        ImGui::ColorEdit4("Budget Lines##4", &pwHistogram.MarkerColor.x);
+        ImGui::SliderFloat("Budget Thickness##4", &pwHistogram.MarkerThick, 1, 10, "%.0f");
+      }
+      if (ImGui::CollapsingHeader("Stat Channels")) {
+        static char s_StatName[128] = "";
+        ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.6f);
+        ImGui::InputText("##StatName", s_StatName, IM_ARRAYSIZE(s_StatName)); ImGui::SameLine();
+        if (ImGui::Button("Bind##5") && s_StatName[0] != '\0') {
+          BindStatChannel(ANSI_TO_TCHAR(s_StatName));
+          s_StatName[0] = '\0';
+        }
+        ImGui::SameLine(); FDFX_StatData::HelpMarker("Short name of an engine stat, e.g. STAT_InitViews, or DFoundryFX.BindStat <Name>. Its stat group is enabled, cycle counters are plotted in ms over the last 10 s at most.");
+        const uint32 Unresolved = StatChannelValues.Read().Unresolved;
+        for (int32 i = 0; i < StatChannels.Num(); i++) {
+          FStatChannel& Channel = StatChannels[i];
+          ImGui::PushID(i);
+          ImGui::ColorEdit4("##Color", &Channel.Color.x, ImGuiColorEditFlags_NoInputs); ImGui::SameLine();
+          ImGui::Text("%s", TCHAR_TO_ANSI(*Channel.Name));
+          if (Unresolved & (1u << i)) {
+            ImGui::SameLine(); ImGui::TextDisabled("(not declared yet)");
+          }
+          FPlotWindow* Windows[] = { &pwThread, &pwFrame };
+          const char* Labels[] = { "Threads", "Frame" };
+          for (int32 w = 0; w < UE_ARRAY_COUNT(Windows); w++) {
+            bool bBound = Windows[w]->StatChannels.Contains(i);
+            ImGui::SameLine();
+            if (ImGui::Checkbox(Labels[w], &bBound)) {
+              if (bBound) {
+                Windows[w]->StatChannels.Add(i);
+              } else {
+                Windows[w]->StatChannels.Remove(i);
+              }
+            }
+          }
+          ImGui::PopID();
+        }
+      }
       ImGui::Unindent();
     }
   }
@@ -1212,6 +2019,48 @@ void FDFX_StatData::Tab_Settings()
     //ImGui::Checkbox("Use external window", &bExternalWindow);
     ImGui::Checkbox("Disable in-game controls", &bDisableGameControls);
     ImGui::Checkbox("Show Debug Tab", &bShowDebugTab);
+    static const int OverlayRates[] = { 0, 60, 30, 15 };
+    const int OverlayRate = OverlayUpdateRate.Load(EMemoryOrder::Relaxed);
+    int OverlayRateIndex = 0;
+    for (int i = 0; i < IM_ARRAYSIZE(OverlayRates); ++i) {
+      if (OverlayRates[i] == OverlayRate)
+        OverlayRateIndex = i;
+    }
+    ImGui::Text("Overlay Update :"); ImGui::SameLine(); ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+    if (ImGui::Combo("##OverlayUpdateRate", &OverlayRateIndex, "Every frame\0" "60 Hz\0" "30 Hz\0" "15 Hz\0")) {
+      OverlayUpdateRate.Store(OverlayRates[OverlayRateIndex], EMemoryOrder::Relaxed);
+    }
+    ImGui::SameLine(); FDFX_StatData::HelpMarker("Rebuild the overlay at a lower rate and reuse it in between. Stats are still sampled every frame.");
+    ImGui::Text("Overlay Budget :"); ImGui::SameLine(); ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+    float OverlayBudget = OverlayBudgetMs.load(std::memory_order_relaxed);
+    if (ImGui::SliderFloat("##OverlayBudget", &OverlayBudget, 0.f, 2.f, OverlayBudget > 0.f ? "%.2f ms" : "Off")) {
+      OverlayBudgetMs.store(OverlayBudget, std::memory_order_relaxed);
+    }
+    ImGui::SameLine(); FDFX_StatData::HelpMarker("Degrade the overlay (update rate, history, tabs, then suspend) while its cost is over this budget.");
+    if (ImGui::TreeNode("Hitches")) {
+      ImGui::SliderFloat("Median Factor", &HitchMedianFactor, 1.2f, 10.f, "%.1f x P50");
+      ImGui::SliderFloat("Budget", &HitchBudgetMs, 0.f, 100.f, HitchBudgetMs > 0.f ? "%.1f ms" : "Off");
+      ImGui::SameLine(); FDFX_StatData::HelpMarker("A frame is a hitch above the median factor times the P50 frame time of the last 10 s, or above the budget when it is set.");
+      ImGui::SliderFloat("Pacing Target", &PacingTargetMs, 0.f, 50.f, PacingTargetMs > 0.f ? "%.2f ms" : "Auto");
+      ImGui::SameLine(); FDFX_StatData::HelpMarker("Frame interval the pacing analysis expects. Auto uses the t.MaxFPS cap, or the median frame time without one.");
+      if (ImGui::Button("Clear Hitch Log")) {
+        HitchLog.Reset();
+        HitchLogHead = 0;
+        HitchCount = 0;
+      }
+      ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Smoothing")) {
+      ImGui::SliderFloat("EMA Time Constant", &FilterTimeConstant, 0.01f, 2.f, "%.2f s", ImGuiSliderFlags_Logarithmic);
+      ImGui::SliderFloat("Average/Median Window", &FilterWindow, 0.05f, 2.f, "%.2f s", ImGuiSliderFlags_Logarithmic);
+      ImGui::SameLine(); FDFX_StatData::HelpMarker("Filters are defined in seconds and give the same curve at any frame rate. Long history and percentiles always use raw values.");
+      for (int i = 0; i < ChannelNum; i++) {
+        if (i == ChannelFPS)
+          continue;
+        ImGui::Combo(ChannelNames[i], &FilterModes[i], "Raw\0" "EMA\0" "Moving Average\0" "Median\0");
+      }
+      ImGui::TreePop();
+    }
     if (ImGui::Button("Reset DFoundryFX")) {
       ImGui::ClearIniSettings();
       bIsDefaultLoaded = false;
@@ -1232,47 +2081,103 @@ void FDFX_StatData::Tab_Debug()
 {
   char s_EnabledStats[32];
   char s_Hitches[32];
+  char s_HitchLog[32];
 
-  snprintf(s_EnabledStats, 32, "Enabled Stats : %i", m_Viewport->GetEnabledStats()->Num());
-  snprintf(s_Hitches, 32, "Hitches : %i", m_Viewport->GetStatHitchesData()->Count);
+  snprintf(s_EnabledStats, 32, "Enabled Stats : %i", EnabledStats.Num());
+  snprintf(s_Hitches, 32, "Engine Hitches : %i", EngineContext.StatHitches.Count);
+  snprintf(s_HitchLog, 32, "Hitch Log : %i###HitchLog", HitchCount);
   
   //ImGui::BeginTabItem("Debug");
-    ImGui::Text("FPS : %2d", m_FramesPerSecond);
-    ImGui::Text("Frame : %4.3f", m_FrameTime);
-    ImGui::Text("Game : %4.3f", m_GameThreadTime);
-    ImGui::Text("Render : %4.3f", m_RenderThreadTime);
-    ImGui::Text("GPU : %4.3f", m_GPUFrameTime);
-    ImGui::Text("RHI : %4.3f", m_RHIThreadTime);
-    ImGui::Text("Swap : %4.3f", m_SwapBufferTime);
-    ImGui::Text("Input : %4.3f", m_InputLatencyTime);
-    ImGui::Text("ImGui : %4.3f", m_ImGuiThreadTime);
+    ImGui::Text("FPS : %2d", ShownFrame.FramesPerSecond);
+    ImGui::Text("Frame : %4.3f | %4.3f raw", ShownFrame.FrameTime, ShownFrame.Raw[ChannelFrame]);
+    ImGui::Text("Game : %4.3f | %4.3f raw", ShownFrame.GameThreadTime, ShownFrame.Raw[ChannelGame]);
+    ImGui::Text("Render : %4.3f | %4.3f raw", ShownFrame.RenderThreadTime, ShownFrame.Raw[ChannelRender]);
+    ImGui::Text("GPU : %4.3f | %4.3f raw", ShownFrame.GPUFrameTime, ShownFrame.Raw[ChannelGPU]);
+    ImGui::Text("RHI : %4.3f | %4.3f raw", ShownFrame.RHIThreadTime, ShownFrame.Raw[ChannelRHI]);
+    ImGui::Text("Swap : %4.3f | %4.3f raw", ShownFrame.SwapBufferTime, ShownFrame.Raw[ChannelSwap]);
+    ImGui::Text("Input : %4.3f | %4.3f raw", ShownFrame.InputLatencyTime, ShownFrame.Raw[ChannelInput]);
+    ImGui::Text("ImGui : %4.3f | %4.3f raw", ShownFrame.ImGuiThreadTime, ShownFrame.Raw[ChannelImGui]);
+    ImGui::Text("UI Build : %4.3f (task)", ShownFrame.UIBuildTime);
+    ImGui::Text("Overlay Cost : %4.3f / %4.3f budget | level %i", OverlayCostMs, OverlayBudgetMs.load(std::memory_order_relaxed), OverlayDegradeLevel);
+    ImGui::Text("Draws : %u | Prims : %u", ShownFrame.DrawCalls, ShownFrame.Primitives);
+    ImGui::Text("Memory : %.1f MB (physical) | %.1f MB (virtual)", ShownFrame.UsedPhysicalMemory / (1024.0 * 1024.0), ShownFrame.UsedVirtualMemory / (1024.0 * 1024.0));
+    ImGui::Text("Snapshot : version %u", PublishedFrame.GetVersion());
+    ImGui::Text("Bound : Game %3.0f%% | Render %3.0f%% | GPU %3.0f%% | RHI %3.0f%% | Present %3.0f%%",
+      GetBoundShare(BoundGame) * 100.f, GetBoundShare(BoundRender) * 100.f, GetBoundShare(BoundGPU) * 100.f,
+      GetBoundShare(BoundRHI) * 100.f, GetBoundShare(BoundPresent) * 100.f);
+    ImGui::Text("History : %i / %i samples x %i channels | %.0f Hz", History.Num(), History.GetCapacity(), History.NumColumns(), HistorySampleInterval > 0 ? 1.0 / HistorySampleInterval : 0.0);
+    ImGui::Text("Long History : %i x 100 ms | %i x 1 s", HistoryLevels[0].Ring.Num(), HistoryLevels[1].Ring.Num());
+    for (int32 i = 0; i < HistoryChannelNames.Num(); i++) {
+      ImGui::Text("%s : %4.3f", TCHAR_TO_ANSI(*HistoryChannelNames[i]), History.Num() > 0 ? History.Last(ChannelNum + i) : 0.f);
+    }
+    ImGui::Text("ImGui Allocs : %i (frame) | %i (total)", FDFX_Renderer::FrameImGuiAllocations.Load(EMemoryOrder::Relaxed), FDFX_Renderer::ImGuiAllocationCount.GetValue());
+    ImGui::Text("Buffer Growth : %i (frame) | %i (total)", FDFX_Renderer::FrameBufferGrowths.Load(EMemoryOrder::Relaxed), FDFX_Renderer::BufferGrowthCount.GetValue());
+    ImGui::Text("Collector : %i queued | %i dropped", static_cast<int>(FrameSamples.Count()), DroppedFrameSamples.GetValue());
+    ImGui::Text("Geometry Cache : %3.0f%% hit | %4.3f ms saved", FDFX_Renderer::GeometryCacheHitRate.load(std::memory_order_relaxed) * 100.f, FDFX_Renderer::GeometryCacheSavedMs.load(std::memory_order_relaxed));
+
+    if (ImGui::CollapsingHeader("Percentiles (ms)")) {
+      ImGui::Text("Window : %i samples | Session : %llu samples", Percentiles.GetWindowCount(), Percentiles.GetSessionCount());
+      if (ImGui::BeginTable("##tblPercentiles", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("");
+        ImGui::TableSetupColumn("P50");
+        ImGui::TableSetupColumn("P95");
+        ImGui::TableSetupColumn("P99");
+        ImGui::TableSetupColumn("P99.9");
+        ImGui::TableSetupColumn("Session P99");
+        ImGui::TableSetupColumn("Session P99.9");
+        ImGui::TableHeadersRow();
+        for (int c = 0; c < ChannelNum; c++) {
+          if (c == ChannelFPS)
+            continue;
+          const auto& Window = Percentiles.GetWindow(c);
+          const auto& Session = Percentiles.GetSession(c);
+          ImGui::TableNextColumn(); ImGui::TextUnformatted(ChannelNames[c]);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Window.P50);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Window.P95);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Window.P99);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Window.P999);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Session.P99);
+          ImGui::TableNextColumn(); ImGui::Text("%4.3f", Session.P999);
+        }
+        ImGui::EndTable();
+      }
+    }
+
+    if (ImGui::CollapsingHeader("Frame Pacing")) {
+      DrawPacing();
+    }
+
+    if (ImGui::CollapsingHeader(s_HitchLog)) {
+      DrawHitchLog();
+    }
 
+    // STAT HITCHES data, only filled while the engine stat is enabled.
     if (ImGui::CollapsingHeader(s_Hitches)) {
       ImGui::Indent();
-      ImGui::Text("Last Time : %4.3f", m_Viewport->GetStatHitchesData()->LastTime);
-      for (int i=0; i < m_Viewport->GetStatHitchesData()->LastTime; ++i) {
-        ImGui::Text("Hitch (ms): %4.3f##%i", m_Viewport->GetStatHitchesData()->Hitches[i], i);
+      const FStatHitchesData& Hitches = EngineContext.StatHitches;
+      ImGui::Text("Last Time : %4.3f", Hitches.LastTime);
+      for (int i=0; i < FMath::Min(Hitches.Count, FStatHitchesData::NumHitches); ++i) {
+        ImGui::Text("Hitch (ms): %4.3f##%i", Hitches.Hitches[i] * 1000.f, i);
       }
       ImGui::Unindent();
     }
     
     if (ImGui::CollapsingHeader(s_EnabledStats)) {
       ImGui::Indent();
-      //const TArray<FString>* EnabledStats = m_Viewport->GetEnabledStats();
       FString JoinedStr;
-      for (auto It = m_Viewport->GetEnabledStats()->CreateConstIterator(); It; ++It) {
+      for (auto It = EnabledStats.CreateConstIterator(); It; ++It) {
         JoinedStr += *It;
         JoinedStr += TEXT(" \n");
       }
       ImGui::Text(TCHAR_TO_ANSI(*JoinedStr));
       ImGui::Unindent();
     }
-    ImGui::Text("Frame Count: %d", m_FrameCount);
+    ImGui::Text("Frame Count: %d", ShownFrame.StatsFrame);
     ImGui::Text("ImGui Frame Count: %i", static_cast<int32>(ImPlotFrameCount));
-    ImGui::Text("Current Time: %f", m_CurrentTime);
-    ImGui::Text("Last Time: %f", m_LastTime);
-    ImGui::Text("Delta Time: %f", m_DiffTime);
-    ImGui::Text("FPS float: %f", 1000 / m_DiffTime);
+    ImGui::Text("Current Time: %f", ShownFrame.Time);
+    ImGui::Text("Last Time: %f", ShownFrame.Time - ShownFrame.DeltaTime);
+    ImGui::Text("Delta Time: %f", ShownFrame.DeltaTime);
+    ImGui::Text("FPS float: %f", 1000 / ShownFrame.DeltaTime);
 
   ImGui::EndTabItem();
 }
@@ -1304,6 +2209,8 @@ void FDFX_StatData::LoadDefaultValues(FVector2D InViewportSize)
       pwFrame.Size = ImVec2(InViewportSize.X * (pwFrame.Size.x / oldViewSize.X), InViewportSize.Y * (pwFrame.Size.y / oldViewSize.Y));
       pwFPS.Position = ImVec2(InViewportSize.X * (pwFPS.Position.x / oldViewSize.X), InViewportSize.Y * (pwFPS.Position.y / oldViewSize.Y));
       pwFPS.Size = ImVec2(InViewportSize.X * (pwFPS.Size.x / oldViewSize.X), InViewportSize.Y * (pwFPS.Size.y / oldViewSize.Y));
+      pwHistogram.Position = ImVec2(InViewportSize.X * (pwHistogram.Position.x / oldViewSize.X), InViewportSize.Y * (pwHistogram.Position.y / oldViewSize.Y));
+      pwHistogram.Size = ImVec2(InViewportSize.X * (pwHistogram.Size.x / oldViewSize.X), InViewportSize.Y * (pwHistogram.Size.y / oldViewSize.Y));
       oldViewSize = ViewSize;
       return;
     }
@@ -1370,6 +2277,20 @@ void FDFX_StatData::LoadDefaultValues(FVector2D InViewportSize)
   pwFPS.MarkerLine = 60;
   pwFPS.MarkerThick = 1;
 
+  pwHistogram.bShowPlot = false;
+  pwHistogram.Range = ImVec2(2, 100);
+  pwHistogram.Position = ImVec2(ViewSize.X / 4, (ViewSize.Y / 3) * 2);
+  pwHistogram.Size = ImVec2(ViewSize.X / 4, ViewSize.Y / 3);
+  pwHistogram.BackgroundColor = ImVec4(0.21, 0.22, 0.23, 0.05);
+  pwHistogram.PlotBackgroundColor = ImVec4(0.32, 0.50, 0.77, 0.05);
+  pwHistogram.PlotStyleFillAlpha = 0.5;
+  pwHistogram.PlotLineColor = ImVec4(0.161, 0.29, 0.478, 1);
+  pwHistogram.PlotShadeColor = ImVec4(0.298, 0.447, 0.69, 1);
+  pwHistogram.MarkerColor = ImVec4(0.0, 0.5, 0.0, 1.0);
+  pwHistogram.MarkerLine = 25; // share axis max, %
+  pwHistogram.MarkerThick = 1;
+  bHistogramSession = false;
+
   bShowPlots = true;
   bPlotsSort = false;
   bShowDebugTab = true;
@@ -1377,24 +2298,53 @@ void FDFX_StatData::LoadDefaultValues(FVector2D InViewportSize)
   StatHistoryGlobal = 10;
 
   ImPlotFrameCount = 0;
-  HistoryTime.Erase();
-  FrameCount.Erase();
-  FrameTime.Erase();
-  FramesPerSecond.Erase();
-  GameThreadTime.Erase();
-  RenderThreadTime.Erase();
-  GPUFrameTime.Erase();
-  RHIThreadTime.Erase();
-  SwapBufferTime.Erase();
-  InputLatencyTime.Erase();
-  ImGuiThreadTime.Erase();
+  History.Erase();
+  HistoryBaseTime = 0;
+  LastHistoryTime = 0;
+  for (FHistoryLevel& Level : HistoryLevels) {
+    Level.Erase();
+  }
+  Percentiles.Reset();
+  LastPercentileUpdate = 0;
+  HitchLog.Reset();
+  HitchLogHead = 0;
+  HitchCount = 0;
+  PacingHead = 0;
+  PacingCount = 0;
+  PacingSum = 0;
+  PacingSumSq = 0;
+  PacingMissed = 0;
+  PacingAlternating = 0;
+  PacingMissedTotal = 0;
+  LastFrameInterval = 0.f;
+  LastFrameDelta = 0.f;
+  if (PacingChannel == INDEX_NONE) {
+    PacingChannel = RegisterHistoryChannel(TEXT("Frame Delta"));
+  }
+  BoundHead = 0;
+  BoundCount = 0;
+  FMemory::Memzero(BoundCounts);
+  for (int i = 0; i < ChannelNum; i++) {
+    FilterModes[i] = static_cast<int>(EDFX_Filter::EMA);
+    Filters[i].Reset();
+  }
+  FilterTimeConstant = 0.15f;
+  FilterWindow = 0.5f;
 
   for (FStatCmd elem : aStatCmds) {
     if (elem.Header == FDFX_StatData::Fav)
       elem.Header = FDFX_StatData::None;
   }
 
-  UpdateStats();
+  // Start from the latest collected frame, the older ones predate the defaults.
+  FFrameSample Sample;
+  bool bHasSample = false;
+  while (FrameSamples.Dequeue(Sample)) {
+    bHasSample = true;
+  }
+  if (bHasSample) {
+    UpdateStats(Sample);
+  }
 
   bIsDefaultLoaded = true;
   oldViewSize = ViewSize;
@@ -1458,7 +2408,7 @@ void FDFX_StatData::DrawSTAT(FDFX_StatData::EStatHeader InHeader, FString InFilt
       ImGui::TableNextColumn(); ImGui::Text(s_StatCmd);
       tmpToggle = elem.Enable;
       ImGui::TableNextColumn(); ToggleButton(s_StatId, &tmpToggle);
-      ToggleStat(elem.Command, tmpToggle);
+      ToggleStat(elem, tmpToggle);
       elem.Enable = tmpToggle;
     }
   }
@@ -1467,6 +2417,72 @@ void FDFX_StatData::DrawSTAT(FDFX_StatData::EStatHeader InHeader, FString InFilt
 #pragma clang diagnostic pop
 #endif
 
+void FDFX_StatData::LoadHistogramPlot()
+{
+  // Display bins merge 5 log buckets (about 10% wide): the plot has the same 140 points whatever the sample count.
+  const int BucketsPerBin = 5;
+  const int NumBins = (FDFX_LogHistogram::NumBuckets - 1 + BucketsPerBin - 1) / BucketsPerBin;
+  const FDFX_LogHistogram& Histogram = bHistogramSession ? Percentiles.GetSessionHistogram(ChannelFrame) : Percentiles.GetWindowHistogram(ChannelFrame);
+  const double Scale = Histogram.GetTotal() > 0 ? 100.0 / Histogram.GetTotal() : 0.0;
+  double BinEdges[NumBins + 1];
+  double BinShares[NumBins + 1];
+  for (int Bin = 0; Bin < NumBins; Bin++) {
+    const int First = 1 + Bin * BucketsPerBin;
+    const int Last = FMath::Min(First + BucketsPerBin, FDFX_LogHistogram::NumBuckets);
+    uint64 Count = 0;
+    for (int Bucket = First; Bucket < Last; Bucket++) {
+      Count += Histogram.GetCount(Bucket);
+    }
+    BinEdges[Bin] = FDFX_LogHistogram::LowerEdgeOf(First);
+    BinShares[Bin] = Count * Scale;
+  }
+  BinEdges[NumBins] = FDFX_LogHistogram::LowerEdgeOf(FDFX_LogHistogram::NumBuckets - 1);
+  BinShares[NumBins] = BinShares[NumBins - 1];
+
+  ImGui::SetNextWindowPos(pwHistogram.Position);
+  ImGui::SetNextWindowSize(pwHistogram.Size);
+  ImGui::SetNextWindowBgAlpha(pwHistogram.BackgroundColor.w);
+  ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
+  ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
+  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+  ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 0.0);
+  ImGui::PushStyleColor(ImGuiCol_WindowBg, pwHistogram.BackgroundColor);
+  ImGui::Begin("Histogram", nullptr, window_flags);
+  ImPlot::PushStyleVar(ImPlotStyleVar_PlotBorderSize, 0.0f);
+  ImPlot::PushStyleVar(ImPlotStyleVar_PlotPadding, ImVec2(0, 0));
+  ImPlot::PushStyleVar(ImPlotStyleVar_PlotMinSize, ImVec2(100, 75));
+  ImPlot::PushStyleVar(ImPlotStyleVar_LegendPadding, ImVec2(0, 0));
+  ImPlot::PushStyleColor(ImPlotCol_PlotBg, pwHistogram.PlotBackgroundColor);
+  ImPlot::BeginPlot(bHistogramSession ? "FRAME-TIME DISTRIBUTION (SESSION)" : "FRAME-TIME DISTRIBUTION", ImVec2(-1, -1), plot_flags | ImPlotFlags_NoLegend);
+  ImPlot::SetupAxes("", "", axis_flags, ImPlotAxisFlags_Opposite | ImPlotAxisFlags_NoLabel);
+  ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+  ImPlot::SetupAxisLimits(ImAxis_X1, pwHistogram.Range.x, pwHistogram.Range.y, ImGuiCond_Always);
+  ImPlot::SetupAxisLimits(ImAxis_Y1, 0, pwHistogram.MarkerLine, ImGuiCond_Always);
+  ImPlot::SetupFinish();
+  ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, pwHistogram.PlotStyleFillAlpha);
+  ImPlot::PushStyleColor(ImPlotCol_Line, pwHistogram.PlotLineColor);
+  ImPlot::PushStyleColor(ImPlotCol_Fill, pwHistogram.PlotShadeColor);
+  ImPlot::PlotStairs("##Histogram", BinEdges, BinShares, NumBins + 1, ImPlotStairsFlags_Shaded);
+  ImPlot::PopStyleColor(2);
+  // Frame budgets of 120, 60 and 30 fps.
+  static const double Budgets[] = { 8.333, 16.667, 33.333 };
+  ImPlot::PushStyleColor(ImPlotCol_Line, pwHistogram.MarkerColor);
+  ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, pwHistogram.MarkerThick);
+  ImPlot::PlotInfLines("##Budgets", Budgets, IM_ARRAYSIZE(Budgets));
+  ImPlot::PopStyleVar();
+  ImPlot::PopStyleColor();
+  for (double Budget : Budgets) {
+    ImPlot::TagX(Budget, pwHistogram.MarkerColor, "%.0f", 1000.0 / Budget);
+  }
+  ImPlot::PopStyleVar();
+  ImPlot::EndPlot();
+  ImPlot::PopStyleColor();
+  ImPlot::PopStyleVar(4);
+  ImGui::End();
+  ImGui::PopStyleColor();
+  ImGui::PopStyleVar(4);
+}
+
 void FDFX_StatData::LoadDemos()
 {
   if (ImGui::Begin("Hello Widget", nullptr, ImGuiWindowFlags_None)) {
@@ -1482,27 +2498,226 @@ void FDFX_StatData::LoadDemos()
   ImPlot::ShowDemoWindow();
 }
 
-void FDFX_StatData::AddShaderLog(int Type, FString Hash, double Time)
+void FDFX_StatData::LoadStressPlot()
 {
-  bool bShaderLogExist = false;
-  for (auto& ShaderLog : ShaderCompilerLog)
+  // A single line far above 64K vertices, ImPlot splits it into commands with VtxOffset.
+  ImGui::SetNextWindowPos(ImVec2(ViewSize.X / 4, ViewSize.Y / 4), ImGuiCond_Appearing);
+  ImGui::SetNextWindowSize(ImVec2(ViewSize.X / 2, ViewSize.Y / 2), ImGuiCond_Appearing);
+  if (ImGui::Begin("Stress Plot", nullptr, ImGuiWindowFlags_NoCollapse)) {
+    if (ImPlot::BeginPlot("##StressPlot", ImVec2(-1, -ImGui::GetTextLineHeightWithSpacing()), ImPlotFlags_NoMenus)) {
+      ImPlot::SetupAxesLimits(0, StressPlotPoints, -1.2, 1.2, ImPlotCond_Always);
+      ImPlot::PlotLineG("Stress", [](int Idx, void*) {
+        return ImPlotPoint(Idx, sin(Idx * 0.0005) + 0.1 * sin(Idx * 0.05));
+      }, nullptr, StressPlotPoints);
+      ImPlot::EndPlot();
+    }
+    ImGui::Text("Points : %i | Vertices : %i", StressPlotPoints, ImGui::GetWindowDrawList()->VtxBuffer.Size);
+  }
+  ImGui::End();
+}
+
+void FDFX_StatData::AddShaderLog(int Type, const FSHAHash& Hash, double Time)
+{
+  FShaderLogEvent Event;
+  Event.Type = Type;
+  Event.Time = Time;
+  Event.Hash = Hash;
+  if (!ShaderLogEvents.Enqueue(Event)) {
+    DroppedShaderEvents.Increment();
+  }
+}
+
+void FDFX_StatData::DrainShaderLog()
+{
+  FShaderLogEvent Event;
+  while (ShaderLogEvents.Dequeue(Event))
   {
-    if (ShaderLog.Hash.Left(40) == Hash.Left(40)) {
-      ShaderLog.Type = ShaderLog.Type | Type;
-      ShaderLog.Time = ShaderLog.Time + Time;
+    if (const int32* Index = ShaderCompilerLogIndex.Find(Event.Hash)) {
+      FShaderCompilerLog& ShaderLog = ShaderCompilerLog[*Index];
+      ShaderLog.Type = ShaderLog.Type | Event.Type;
+      ShaderLog.Time = ShaderLog.Time + Event.Time;
       ShaderLog.Count = ShaderLog.Count + 1;
-      bShaderLogExist = true;
-      break;
+      continue;
     }
-  }
-  if (!bShaderLogExist) {
     FShaderCompilerLog NewItem;
-    NewItem.Type = Type;
-    NewItem.Hash = Hash;
-    NewItem.Time = Time;
+    NewItem.Type = Event.Type;
+    NewItem.Hash = Event.Hash;
+    NewItem.Time = Event.Time;
     NewItem.Count = 1;
-    ShaderCompilerLog.Add(NewItem);
+    ShaderCompilerLogIndex.Add(Event.Hash, ShaderCompilerLog.Add(NewItem));
+  }
+}
+
+bool FDFX_StatData::StressShaderLog(int32 Producers, int32 EventsPerProducer)
+{
+  // Same record and ring as the live log, the producer id and sequence number are packed in the hash bytes.
+  TUniquePtr<TDFX_MpscQueue<FShaderLogEvent, 4096>> Queue = MakeUnique<TDFX_MpscQueue<FShaderLogEvent, 4096>>();
+  FThreadSafeCounter FullRetries;
+  const double BeginTime = FPlatformTime::Seconds();
+
+  TArray<TFuture<void>> Tasks;
+  for (int32 Producer = 0; Producer < Producers; Producer++)
+  {
+    Tasks.Add(Async(EAsyncExecution::Thread, [&Queue, &FullRetries, Producer, EventsPerProducer]()
+    {
+      FShaderLogEvent Event;
+      Event.Type = 1 << (Producer % 3);
+      Event.Time = 0.0;
+      for (int32 Sequence = 0; Sequence < EventsPerProducer; Sequence++)
+      {
+        FMemory::Memcpy(&Event.Hash.Hash[0], &Producer, sizeof(int32));
+        FMemory::Memcpy(&Event.Hash.Hash[4], &Sequence, sizeof(int32));
+        while (!Queue->Enqueue(Event)) {
+          FullRetries.Increment();
+          FPlatformProcess::Yield();
+        }
+      }
+    }));
+  }
+
+  // Consume on this thread while the producers run, every producer's events must arrive once and in order.
+  TArray<int32> NextSequence;
+  NextSequence.SetNumZeroed(Producers);
+  const int64 Total = static_cast<int64>(Producers) * EventsPerProducer;
+  int64 Received = 0;
+  int64 Errors = 0;
+  FShaderLogEvent Event;
+  while (Received < Total)
+  {
+    if (!Queue->Dequeue(Event)) {
+      FPlatformProcess::Yield();
+      continue;
+    }
+    int32 Producer, Sequence;
+    FMemory::Memcpy(&Producer, &Event.Hash.Hash[0], sizeof(int32));
+    FMemory::Memcpy(&Sequence, &Event.Hash.Hash[4], sizeof(int32));
+    if (!NextSequence.IsValidIndex(Producer) || NextSequence[Producer] != Sequence) {
+      Errors++;
+    }
+    if (NextSequence.IsValidIndex(Producer)) {
+      NextSequence[Producer] = Sequence + 1;
+    }
+    Received++;
+  }
+  for (TFuture<void>& Task : Tasks) {
+    Task.Wait();
+  }
+
+  const double Elapsed = FPlatformTime::Seconds() - BeginTime;
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Shader log stress %d producers x %d events, %lld received, %lld errors, %d full retries, %.0f events/sec."),
+    Producers, EventsPerProducer, Received, Errors, FullRetries.GetValue(), Elapsed > 0.0 ? Received / Elapsed : 0.0);
+  return Errors == 0;
+}
+
+bool FDFX_StatData::BenchmarkFrameSnapshot(int32 Readers, float Seconds)
+{
+  // Every field of a written snapshot derives from FrameNumber, a torn copy would mix two of them.
+  struct FWriteResult {
+    uint64 Writes = 0;
+    uint64 MaxCycles = 0;
+  };
+  auto RunWriter = [Seconds](TDFX_SeqLock<FFrameSnapshot>& Lock)
+  {
+    FWriteResult Result;
+    FFrameSnapshot Snapshot {};
+    const double EndTime = FPlatformTime::Seconds() + Seconds;
+    while (FPlatformTime::Seconds() < EndTime)
+    {
+      for (int i = 0; i < 1024; i++)
+      {
+        Snapshot.FrameNumber = ++Result.Writes;
+        Snapshot.Time = static_cast<double>(Snapshot.FrameNumber);
+        Snapshot.GameThreadTime = static_cast<float>(Snapshot.FrameNumber & 0xFFFF);
+        Snapshot.UsedPhysicalMemory = Snapshot.FrameNumber * 2;
+        const uint64 BeginCycles = FPlatformTime::Cycles64();
+        Lock.Write(Snapshot);
+        Result.MaxCycles = FMath::Max(Result.MaxCycles, FPlatformTime::Cycles64() - BeginCycles);
+      }
+    }
+    return Result;
+  };
+
+  TUniquePtr<TDFX_SeqLock<FFrameSnapshot>> Lock = MakeUnique<TDFX_SeqLock<FFrameSnapshot>>();
+  const FWriteResult Alone = RunWriter(*Lock);
+
+  FThreadSafeBool bStop = false;
+  FThreadSafeCounter64 Reads;
+  FThreadSafeCounter64 Retries;
+  FThreadSafeCounter64 Torn;
+  TArray<TFuture<void>> Tasks;
+  for (int32 Reader = 0; Reader < Readers; Reader++)
+  {
+    Tasks.Add(Async(EAsyncExecution::Thread, [&Lock, &bStop, &Reads, &Retries, &Torn]()
+    {
+      while (!bStop)
+      {
+        uint32 ReadRetries = 0;
+        const FFrameSnapshot Snapshot = Lock->Read(&ReadRetries);
+        if (Snapshot.Time != static_cast<double>(Snapshot.FrameNumber) ||
+            Snapshot.GameThreadTime != static_cast<float>(Snapshot.FrameNumber & 0xFFFF) ||
+            Snapshot.UsedPhysicalMemory != Snapshot.FrameNumber * 2) {
+          Torn.Increment();
+        }
+        Reads.Increment();
+        Retries.Add(ReadRetries);
+      }
+    }));
   }
+  const FWriteResult Contended = RunWriter(*Lock);
+  bStop = true;
+  for (TFuture<void>& Task : Tasks) {
+    Task.Wait();
+  }
+
+  const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Snapshot writer alone %.1f M writes/sec, max %.0f ns."),
+    Alone.Writes / Seconds / 1e6, Alone.MaxCycles * NsPerCycle);
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Snapshot writer with %d readers %.1f M writes/sec, max %.0f ns | %.1f M reads/sec, %lld retries, %lld torn."),
+    Readers, Contended.Writes / Seconds / 1e6, Contended.MaxCycles * NsPerCycle, Reads.GetValue() / Seconds / 1e6, Retries.GetValue(), Torn.GetValue());
+  return Torn.GetValue() == 0;
+}
+
+bool FDFX_StatData::BenchmarkPercentiles(int32 Samples)
+{
+  // Uniform 1..33 ms on every channel, 10 kHz sample clock: the window holds the last 10 s, the session everything.
+  TUniquePtr<TDFX_PercentileTracker<ChannelNum>> Tracker = MakeUnique<TDFX_PercentileTracker<ChannelNum>>(StatHistoryMax, 16384);
+  FRandomStream Random(1234);
+  const int32 TableRows = 65536;
+  TArray<double> Values;
+  Values.SetNumUninitialized(TableRows * ChannelNum);
+  for (double& Value : Values) {
+    Value = 1.0 + 32.0 * Random.GetFraction();
+  }
+
+  uint64 MaxCycles = 0;
+  const uint64 BeginCycles = FPlatformTime::Cycles64();
+  for (int32 i = 0; i < Samples; i++)
+  {
+    const uint64 SampleCycles = FPlatformTime::Cycles64();
+    Tracker->Add(i * 0.0001, &Values[(i % TableRows) * ChannelNum]);
+    MaxCycles = FMath::Max(MaxCycles, FPlatformTime::Cycles64() - SampleCycles);
+  }
+  const uint64 AddCycles = FPlatformTime::Cycles64() - BeginCycles;
+
+  const uint64 UpdateBegin = FPlatformTime::Cycles64();
+  Tracker->Update();
+  const uint64 UpdateCycles = FPlatformTime::Cycles64() - UpdateBegin;
+
+  // Expected quantiles of the uniform distribution, the histogram is good to 1%, the sampling adds a little.
+  bool bPassed = true;
+  const auto& Session = Tracker->GetSession(ChannelFrame);
+  const float Expected[4] = { 17.f, 31.4f, 32.68f, 32.968f };
+  const float Measured[4] = { Session.P50, Session.P95, Session.P99, Session.P999 };
+  for (int i = 0; i < 4; i++) {
+    bPassed &= FMath::Abs(Measured[i] - Expected[i]) <= Expected[i] * 0.02f;
+  }
+
+  const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Percentiles %d samples x %d channels, %.1f ns per sample (max %.0f ns), update %.1f us."),
+    Samples, static_cast<int32>(ChannelNum), AddCycles * NsPerCycle / FMath::Max(Samples, 1), MaxCycles * NsPerCycle, UpdateCycles * NsPerCycle / 1000.0);
+  UE_LOG(LogDFoundryFX, Log, TEXT("StatData: Percentiles session P50 %.3f P95 %.3f P99 %.3f P99.9 %.3f (expected %.3f %.3f %.3f %.3f)."),
+    Measured[0], Measured[1], Measured[2], Measured[3], Expected[0], Expected[1], Expected[2], Expected[3]);
+  return bPassed;
 }
 
 void FDFX_StatData::ToggleButton(const char* str_id, bool* v)
@@ -1532,13 +2747,12 @@ void FDFX_StatData::ToggleButton(const char* str_id, bool* v)
     ImVec2((p.x + (width / 2) + center.x) - 9.0f, p.y + height - 1.5f), IM_COL32(255, 255, 255, 255), height * rounding);
 }
 
-void FDFX_StatData::ToggleStat(FString StatName, bool& bValue)
+void FDFX_StatData::ToggleStat(const FStatCmd& Stat, bool bValue)
 {
-  bool bStatEnable = m_Viewport->IsStatEnabled(StatName);
-  if (bValue && !bStatEnable ||
-     !bValue && bStatEnable) {
-    FString sCmd = FString("Stat ").Append(StatName);
-    m_Viewport->ConsoleCommand(sCmd);
+  // Stat.Enable is the engine state read by PrepareDFoundryFX.
+  if (bValue != Stat.Enable) {
+    FString sCmd = FString("Stat ").Append(Stat.Command);
+    ConsoleCommand(sCmd);
   }
 }
 
@@ -12,6 +12,7 @@ FDFX_Thread::FDFX_Thread()
   hOnGameModeInitialized = FDelegateHandle();
   hOnWorldBeginPlay = FDelegateHandle();
   hOnHUDPostRender = FDelegateHandle();
+  hOnEndFrame = FCoreDelegates::OnEndFrame.AddStatic(&FDFX_StatData::PublishFrameClock);
 
   // Thread
   UE_LOG(LogDFoundryFX, Log, TEXT("Thread: Initializing DFoundryFX multithread."));
@@ -25,6 +26,13 @@ FDFX_Thread::~FDFX_Thread()
   UE_LOG(LogDFoundryFX, Log, TEXT("Thread: Destroying DFoundryFX multithread."));
 
   RemoveDelegates();
+  if (hOnEndFrame.IsValid()) {
+    FCoreDelegates::OnEndFrame.Remove(hOnEndFrame);
+    hOnEndFrame.Reset();
+  }
+  ReleaseOverlayTarget();
+  WaitUIBuildTask();
+  WaitFontAtlasTask();
 
   // Thread
   if (DFoundryFX_Thread != nullptr)
@@ -60,6 +68,7 @@ void FDFX_Thread::OnGameModeInitialized(AGameModeBase* aGameMode)
 {
   // ImGui
   UE_LOG(LogDFoundryFX, Log, TEXT("Thread: Initializing ImGui resources and context."));
+  FDFX_Renderer::InstallImGuiAllocator();
   m_ImGuiContext = ImGui::CreateContext();
   m_ImPlotContext = ImPlot::CreateContext();
   ImGui_ImplUE_CreateDeviceObjects();
@@ -77,8 +86,8 @@ void FDFX_Thread::OnGameModeInitialized(AGameModeBase* aGameMode)
   [this](const TSharedRef<SWindow>& Window) {
     FDFX_Thread::OnViewportClose();
   });
-  //hOnPipelineStateLogged = FPipelineFileCacheManager::OnPipelineStateLogged().AddRaw(this, &FDFX_Thread::OnPipelineStateLogged);
-  ShaderLogTime = FApp::GetCurrentTime();
+  hOnPipelineStateLogged = FPipelineFileCacheManager::OnPipelineStateLogged().AddRaw(this, &FDFX_Thread::OnPipelineStateLogged);
+  ShaderLogCycles = FPlatformTime::Cycles64();
 }
 
 
@@ -133,6 +142,13 @@ bool FDFX_Thread::OnViewportClose()
   //ExternalWindow(true);
 
   RemoveDelegates();
+  WaitUIBuildTask();
+  WaitFontAtlasTask();
+
+  // Drop the last frame, it references the fonts of the context destroyed below.
+  m_DrawData.GetWriteBuffer().Reset();
+  m_DrawData.Publish();
+  ApplyPendingFontTexture();
 
   // ImGui
   if (m_ImGuiContext) {
@@ -145,6 +161,7 @@ bool FDFX_Thread::OnViewportClose()
 
   ViewportSize = FVector2D::ZeroVector;
   m_ImGuiDiffTime = 0;
+  ReleaseOverlayTarget();
 
   // Hook for the next viewport/PIE
   hOnGameModeInitialized = FGameModeEvents::OnGameModeInitializedEvent().AddRaw(this, &FDFX_Thread::OnGameModeInitialized);
@@ -155,29 +172,28 @@ bool FDFX_Thread::OnViewportClose()
 
 void FDFX_Thread::OnPipelineStateLogged(FPipelineCacheFileFormatPSO& PipelineCacheFileFormatPSO)
 {
-  FString AssetName = "";
-  double m_ShaderLogDiff = FApp::GetCurrentTime() - ShaderLogTime;
-  uint32 m_hash = PipelineCacheFileFormatPSO.Hash;
+  // Called from whichever thread created the PSO: no allocation, no shared state besides the atomic timestamp.
+  const uint64 m_Cycles = FPlatformTime::Cycles64();
+  const double m_ShaderLogDiff = (m_Cycles - ShaderLogCycles.Exchange(m_Cycles)) * FPlatformTime::GetSecondsPerCycle64();
   uint32 m_type = static_cast<int>(PipelineCacheFileFormatPSO.Type);
 
   switch(m_type) {
     case 0:  //Compute
       FDFX_StatData::AddShaderLog(1, 
-        *PipelineCacheFileFormatPSO.ComputeDesc.ComputeShader.ToString(), 
+        PipelineCacheFileFormatPSO.ComputeDesc.ComputeShader, 
         m_ShaderLogDiff);
       break;
     case 1:  //Graphics
       FDFX_StatData::AddShaderLog(2,
-        *PipelineCacheFileFormatPSO.GraphicsDesc.ShadersToString(),
+        PipelineCacheFileFormatPSO.GraphicsDesc.VertexShader,
         m_ShaderLogDiff);
       break;
     case 2:  //Raytracing
       FDFX_StatData::AddShaderLog(4,
-        *PipelineCacheFileFormatPSO.RayTracingDesc.ShaderHash.ToString(),
+        PipelineCacheFileFormatPSO.RayTracingDesc.ShaderHash,
         m_ShaderLogDiff);
       break;
   }
-  ShaderLogTime = FApp::GetCurrentTime();
 }
 
 
@@ -209,39 +225,186 @@ bool FDFX_Thread::ImGui_ImplUE_Init()
 
 bool FDFX_Thread::ImGui_ImplUE_CreateDeviceObjects()
 {
-  // Build texture atlas
-  const ImGuiIO& IO = GetImGuiIO();
-  unsigned char* Pixels;
-  int Width, Height;
-  IO.Fonts->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
-
+  // Build texture atlas, the default atlas is uploaded once and shared by every context.
+  ImGuiIO& IO = GetImGuiIO();
+  const bool bAlpha8 = UseFontAlpha8();
+  TArray<ImWchar> GlyphRanges;
+  ParseGlyphRanges(FDFX_StatData::FontGlyphRanges, GlyphRanges);
+  BuildFontAtlas(IO.Fonts, 1.f, GlyphRanges, bAlpha8);
   if (!FDFX_Module::FontTexture_Updated) {
-    AsyncTask(ENamedThreads::GameThread, [=](){
-      UE_LOG(LogDFoundryFX, Log, TEXT("ImGui FontTexture : TexData %d x %d."), Width, Height);
-  
-      FDFX_Module::FontTexture->UnlinkStreaming();
-      FTexture2DMipMap& Mip = FDFX_Module::FontTexture->GetPlatformData()->Mips[0];
-      void* Data = Mip.BulkData.Lock(LOCK_READ_WRITE);
-      const int Size = Width * Height * 4; // Fix lnt-arithmetic-overflow warning
-      FMemory::Memcpy(Data, Pixels, Size);
-      Mip.BulkData.Unlock();
-
-      FDFX_Module::FontTexture->UpdateResource();
-      FDFX_Module::MaterialInstance->SetTextureParameterValue(FName("param"), FDFX_Module::FontTexture);
-      //FDFX_Module::MaterialInstance->Shader(EMaterialShaderPrecompileMode::Synchronous);
-      //FDFX_Module::MaterialInstance->AllMaterialsCacheResourceShadersForRendering(); DX12 ValidateBoundUniformBuffer Crash
-      FDFX_Module::FontTexture_Updated = true;
-    });
+    UploadFontTexture(FDFX_Module::FontTexture, IO.Fonts, bAlpha8);
+    ApplyFontTexture(FDFX_Module::FontTexture, bAlpha8);
+    FDFX_Module::FontTexture_Updated = true;
   }
+  m_FontDPIScale = 1.f;
+  m_FontAtlasRevision = FDFX_StatData::FontAtlasRevision;
 
   // Store our identifier
   IO.Fonts->TexID = static_cast<void*>(FDFX_Module::FontTexture);
 
-  UE_LOG(LogDFoundryFX, Log, TEXT("ImGui FontTexture loaded %d x %d.."), Width, Height);
+  UE_LOG(LogDFoundryFX, Log, TEXT("ImGui FontTexture loaded %d x %d.."), IO.Fonts->TexWidth, IO.Fonts->TexHeight);
 
   return true;
 }
 
+bool FDFX_Thread::UseFontAlpha8()
+{
+  return FDFX_StatData::bFontAlpha8 && FDFX_Module::MaterialInstanceAlpha8 != nullptr;
+}
+
+void FDFX_Thread::ParseGlyphRanges(const FString& InRanges, TArray<ImWchar>& OutRanges)
+{
+  // "0x0020-0x007E,0x00B0" -> { 0x20, 0x7E, 0xB0, 0xB0, 0 }
+  OutRanges.Reset();
+  TArray<FString> Entries;
+  InRanges.ParseIntoArray(Entries, TEXT(","));
+  for (const FString& Entry : Entries)
+  {
+    FString First = Entry, Last = Entry;
+    Entry.Split(TEXT("-"), &First, &Last);
+    const uint64 Begin = FCString::Strtoui64(*First.TrimStartAndEnd(), nullptr, 16);
+    const uint64 End = FCString::Strtoui64(*Last.TrimStartAndEnd(), nullptr, 16);
+    if (Begin == 0 || Begin > End || End > IM_UNICODE_CODEPOINT_MAX) {
+      UE_LOG(LogDFoundryFX, Warning, TEXT("ImGui FontTexture : Ignoring glyph range '%s'."), *Entry);
+      continue;
+    }
+    OutRanges.Add(static_cast<ImWchar>(Begin));
+    OutRanges.Add(static_cast<ImWchar>(End));
+  }
+  if (OutRanges.Num() > 0) {
+    OutRanges.Add(0);
+  }
+}
+
+void FDFX_Thread::BuildFontAtlas(ImFontAtlas* Atlas, float DPIScale, const TArray<ImWchar>& GlyphRanges, bool bAlpha8)
+{
+  // Only the configured glyphs are rasterized, software mouse cursors are never drawn by the overlay.
+  Atlas->Clear();
+  Atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
+  ImFontConfig Config;
+  Config.SizePixels = FMath::RoundToFloat(13.f * DPIScale);
+  Config.GlyphRanges = GlyphRanges.Num() > 0 ? GlyphRanges.GetData() : nullptr;
+  Atlas->AddFontDefault(&Config);
+  Atlas->Build();
+
+  // Bake the texture data in the uploaded format, then drop the ranges and TTF data only needed by the build.
+  unsigned char* Pixels;
+  int Width, Height;
+  if (bAlpha8) {
+    Atlas->GetTexDataAsAlpha8(&Pixels, &Width, &Height);
+  } else {
+    Atlas->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
+  }
+  Atlas->ClearInputData();
+}
+
+void FDFX_Thread::UploadFontTexture(UTexture2D*& Texture, ImFontAtlas* Atlas, bool bAlpha8)
+{
+  unsigned char* Pixels;
+  int Width, Height;
+  if (bAlpha8) {
+    Atlas->GetTexDataAsAlpha8(&Pixels, &Width, &Height);
+  } else {
+    Atlas->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
+  }
+  const EPixelFormat Format = bAlpha8 ? PF_G8 : PF_R8G8B8A8;
+  const uint32 BytesPerPixel = bAlpha8 ? 1 : 4;
+
+  // A new transient texture is only needed when the atlas size or format changes.
+  if (!Texture || Texture->GetSizeX() != Width || Texture->GetSizeY() != Height || Texture->GetPixelFormat() != Format) {
+    if (Texture) {
+      Texture->RemoveFromRoot();
+    }
+    Texture = UTexture2D::CreateTransient(Width, Height, Format);
+    Texture->SRGB = !bAlpha8; // Coverage is linear.
+    Texture->AddToRoot();
+  }
+  if (!Texture->GetResource()) {
+    Texture->UpdateResource();
+  }
+
+  // The pixels are copied to the render thread with the region update, no BulkData lock or game thread flush.
+  const uint32 Pitch = Width * BytesPerPixel;
+  const uint32 Size = Pitch * Height;
+  uint8* Data = static_cast<uint8*>(FMemory::Malloc(Size));
+  FMemory::Memcpy(Data, Pixels, Size);
+  FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Width, Height);
+  Texture->UpdateTextureRegions(0, 1, Region, Pitch, BytesPerPixel, Data, [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+  {
+    FMemory::Free(SrcData);
+    delete Regions;
+  });
+  UE_LOG(LogDFoundryFX, Log, TEXT("ImGui FontTexture : TexData %d x %d %s."), Width, Height, bAlpha8 ? TEXT("Alpha8") : TEXT("RGBA32"));
+}
+
+void FDFX_Thread::ApplyFontTexture(UTexture2D* Texture, bool bAlpha8)
+{
+  FDFX_Module::FontTexture = Texture;
+  FDFX_Module::MaterialInstance = bAlpha8 ? FDFX_Module::MaterialInstanceAlpha8 : FDFX_Module::MaterialInstanceRGBA32;
+  FDFX_Module::MaterialInstance->SetTextureParameterValue(FName("param"), Texture);
+}
+
+void FDFX_Thread::ImGui_ImplUE_UpdateFontAtlas()
+{
+  // Swap in an atlas finished by the worker before the next build. The frame already published still uses the
+  // old texture, the renderer switches to the new one once a frame built with it is acquired.
+  if (!m_PendingFontTexture) {
+    if (ImFontAtlas* Atlas = m_PendingFontAtlas.Exchange(nullptr)) {
+      ImGuiIO& IO = GetImGuiIO();
+      const bool bAlpha8 = Atlas->TexPixelsRGBA32 == nullptr;
+      UTexture2D* Texture = nullptr;
+      UploadFontTexture(Texture, Atlas, bAlpha8);
+      Atlas->TexID = static_cast<void*>(Texture);
+      IM_DELETE(IO.Fonts);
+      IO.Fonts = Atlas;
+      m_PendingFontTexture = Texture;
+      m_bPendingFontAlpha8 = bAlpha8;
+    }
+  }
+
+  const float DPIScale = GameViewport ? GameViewport->GetDPIScale() : 1.f;
+  const int Revision = FDFX_StatData::FontAtlasRevision;
+  if ((DPIScale == m_FontDPIScale && Revision == m_FontAtlasRevision) || (m_FontAtlasTask.IsValid() && !m_FontAtlasTask.IsReady()))
+    return;
+
+  m_FontDPIScale = DPIScale;
+  m_FontAtlasRevision = Revision;
+  // Settings are read here, the worker only sees its own copies.
+  const bool bAlpha8 = UseFontAlpha8();
+  TArray<ImWchar> GlyphRanges;
+  ParseGlyphRanges(FDFX_StatData::FontGlyphRanges, GlyphRanges);
+  m_FontAtlasTask = Async(EAsyncExecution::ThreadPool, [this, DPIScale, GlyphRanges = MoveTemp(GlyphRanges), bAlpha8]()
+  {
+    // Atlas building only touches the atlas itself, it does not need the ImGui context.
+    ImFontAtlas* Atlas = IM_NEW(ImFontAtlas)();
+    BuildFontAtlas(Atlas, DPIScale, GlyphRanges, bAlpha8);
+    if (ImFontAtlas* Stale = m_PendingFontAtlas.Exchange(Atlas)) {
+      IM_DELETE(Stale);
+    }
+  });
+}
+
+void FDFX_Thread::ApplyPendingFontTexture()
+{
+  if (!m_PendingFontTexture)
+    return;
+
+  FDFX_Module::FontTexture->RemoveFromRoot();
+  ApplyFontTexture(m_PendingFontTexture, m_bPendingFontAlpha8);
+  FDFX_Module::FontTexture_Updated = false; // The shared texture no longer holds the default atlas.
+  m_PendingFontTexture = nullptr;
+}
+
+void FDFX_Thread::WaitFontAtlasTask()
+{
+  if (m_FontAtlasTask.IsValid()) {
+    m_FontAtlasTask.Wait();
+  }
+  if (ImFontAtlas* Atlas = m_PendingFontAtlas.Exchange(nullptr)) {
+    IM_DELETE(Atlas);
+  }
+}
+
 void FDFX_Thread::ImGui_ImplUE_Render()
 {
   const uint64 M_ImGuiBeginTime = FPlatformTime::Cycles64();
@@ -249,54 +412,160 @@ void FDFX_Thread::ImGui_ImplUE_Render()
     SCOPE_CYCLE_COUNTER(STAT_ThreadProcEvents);
     ImGui_ImplUE_ProcessEvent();
   }
-  { 
-    SCOPE_CYCLE_COUNTER(STAT_ThreadNewFrame);
-    ImGui_ImplUE_NewFrame();
+
+  // Latest frame finished by the UI build, if any since the last call.
+  const bool bNewDrawData = m_DrawData.Acquire();
+  if (bNewDrawData && m_PendingFontTexture && m_DrawData.GetReadBuffer().FontTexture == static_cast<ImTextureID>(m_PendingFontTexture)) {
+    ApplyPendingFontTexture();
   }
-  FDFX_StatData::RunDFoundryFX(GameViewport, m_ImGuiDiffTime * 1000);
-  { 
-    SCOPE_CYCLE_COUNTER(STAT_ThreadRender);
-    ImGui::Render();
+
+  // With an update rate the overlay is only rebuilt when due, the cached target is composited every frame.
+  const int UpdateRate = GetOverlayUpdateRate();
+  const bool bCached = UpdateRate > 0;
+  const bool bSuspended = m_OverlayDegradeLevel >= FDFX_StatData::DegradeSuspended;
+  const double CurrentTime = FPlatformTime::Seconds();
+  const bool bTargetStale = !m_OverlayTarget || m_OverlayTarget->SizeX != static_cast<int32>(ViewportSize.X) || m_OverlayTarget->SizeY != static_cast<int32>(ViewportSize.Y);
+  const bool bDue = !bCached || CurrentTime - m_OverlayLastUpdate >= 1.0 / UpdateRate;
+  if ((bTargetStale || (bDue && !bSuspended)) && IsUIBuildIdle())
+  {
+    m_OverlayLastUpdate = CurrentTime;
+    { 
+      SCOPE_CYCLE_COUNTER(STAT_ThreadNewFrame);
+      ImGui_ImplUE_NewFrame();
+    }
+  }
+  else if (bSuspended && IsUIBuildIdle())
+  {
+    ImGui_ImplUE_SampleOnly();
   }
   { 
     SCOPE_CYCLE_COUNTER(STAT_ThreadDraw);
-    ImGui_ImplUE_RenderDrawLists();
+    if (bCached) {
+      if (bNewDrawData || bTargetStale) {
+        ImGui_ImplUE_RenderOverlayTarget();
+      }
+      ImGui_ImplUE_CompositeOverlay();
+    } else {
+      if (m_OverlayTarget) {
+        ReleaseOverlayTarget();
+      }
+      ImGui_ImplUE_RenderDrawLists(uCanvas);
+    }
   }
   const uint64 M_ImGuiEndTime = FPlatformTime::Cycles64();
   m_ImGuiDiffTime = M_ImGuiEndTime - M_ImGuiBeginTime;
+  UpdateOverlayBudget(m_ImGuiDiffTime + (bNewDrawData ? m_UIBuildTime : 0), CurrentTime);
 }
 
-void FDFX_Thread::ImGui_ImplUE_ProcessEvent()
+int FDFX_Thread::GetOverlayUpdateRate() const
 {
-  if (!ControllerInput())
+  static const int DegradedRates[] = { 0, 30, 15, 5, 5 };
+  const int Level = FMath::Clamp(m_OverlayDegradeLevel, 0, static_cast<int>(UE_ARRAY_COUNT(DegradedRates)) - 1);
+  const int Rate = FDFX_StatData::OverlayUpdateRate.Load(EMemoryOrder::Relaxed);
+  if (Level == FDFX_StatData::DegradeNone)
+    return Rate;
+  return Rate > 0 ? FMath::Min(Rate, DegradedRates[Level]) : DegradedRates[Level];
+}
+
+void FDFX_Thread::UpdateOverlayBudget(uint64 FrameCycles, double CurrentTime)
+{
+  // Game-thread cost every frame, plus the UI build cost on the frames it completes: the average cost per frame.
+  m_OverlayCostMs = 0.95 * m_OverlayCostMs + 0.05 * FPlatformTime::ToMilliseconds64(FrameCycles);
+
+  const int Level = m_OverlayDegradeLevel;
+  const float Budget = FDFX_StatData::OverlayBudgetMs.load(std::memory_order_relaxed);
+  if (Budget <= 0.f) {
+    if (Level != FDFX_StatData::DegradeNone) {
+      SetOverlayDegradeLevel(FDFX_StatData::DegradeNone, CurrentTime);
+    }
+    m_OverlayProbeDelay = 2.0;
+    m_bOverlayProbing = false;
     return;
+  }
 
-  ImGuiIO& IO = GetImGuiIO();
+  if (Level == FDFX_StatData::DegradeNone) {
+    m_OverlayProbeDelay = 2.0;
+    m_bOverlayProbing = false;
+  }
 
-  IO.KeyShift = PlayerController->IsInputKeyDown(EKeys::LeftShift) || PlayerController->IsInputKeyDown(EKeys::RightShift);
-  IO.KeyCtrl = PlayerController->IsInputKeyDown(EKeys::LeftControl) || PlayerController->IsInputKeyDown(EKeys::RightControl);
-  IO.KeyAlt = PlayerController->IsInputKeyDown(EKeys::LeftAlt) || PlayerController->IsInputKeyDown(EKeys::RightAlt);
-  IO.KeySuper = false;
+  // Each level is held long enough for the smoothed cost to reflect it. Stepping back up is a probe, a suspended
+  // overlay always looks cheap: a probe dropped within ProbeWindow doubles the delay before the next one,
+  // a probe that holds resets it.
+  const double ProbeWindow = 5.0;
+  const double Held = CurrentTime - m_OverlayLevelTime;
+  if (m_OverlayCostMs > Budget && Level < FDFX_StatData::DegradeSuspended && Held >= 0.5) {
+    if (m_bOverlayProbing && Held < ProbeWindow) {
+      m_OverlayProbeDelay = FMath::Min(m_OverlayProbeDelay * 2.0, 64.0);
+    }
+    m_bOverlayProbing = false;
+    SetOverlayDegradeLevel(Level + 1, CurrentTime);
+  } else if (m_OverlayCostMs < Budget * 0.5 && Level > FDFX_StatData::DegradeNone && Held >= m_OverlayProbeDelay) {
+    m_bOverlayProbing = true;
+    SetOverlayDegradeLevel(Level - 1, CurrentTime);
+  } else if (m_bOverlayProbing && Held >= ProbeWindow) {
+    m_bOverlayProbing = false;
+    m_OverlayProbeDelay = 2.0;
+  }
+}
+
+void FDFX_Thread::SetOverlayDegradeLevel(int Level, double CurrentTime)
+{
+  UE_LOG(LogDFoundryFX, Log, TEXT("Thread: Overlay cost %.3f ms for a %.2f ms budget, degrade level %d -> %d."),
+    m_OverlayCostMs, FDFX_StatData::OverlayBudgetMs.load(std::memory_order_relaxed), m_OverlayDegradeLevel, Level);
+  m_OverlayDegradeLevel = Level;
+  m_OverlayLevelTime = CurrentTime;
+}
+
+void FDFX_Thread::PrepareOverlayBudget()
+{
+  // Called with the UI task idle, the task reads these copies instead of the governor state.
+  FDFX_StatData::OverlayCostMs = static_cast<float>(m_OverlayCostMs);
+  FDFX_StatData::OverlayDegradeLevel = m_OverlayDegradeLevel;
+}
+
+void FDFX_Thread::ImGui_ImplUE_ProcessEvent()
+{
+  // Input is only captured here, the ImGui IO belongs to the UI build.
+  m_Input.DisplaySize = ImVec2(static_cast<float>(ViewportSize.X), static_cast<float>(ViewportSize.Y));
+  if (PlayerController)
+  {
+    const FKey MouseButtons[3] = { EKeys::LeftMouseButton, EKeys::RightMouseButton, EKeys::MiddleMouseButton };
+    PlayerController->GetMousePosition(m_Input.MousePos.x, m_Input.MousePos.y);
+    for (int Button = 0; Button < 3; Button++) {
+      m_Input.MouseDown[Button] = PlayerController->IsInputKeyDown(MouseButtons[Button]);
+      m_Input.MouseClicked[Button] |= m_Input.MouseDown[Button];
+    }
+  }
+
+  //TODO : Add MouseWheelAxis
+  //io.AddMouseWheelEvent(0.f, PlayerController->IsInputKeyDown(EKeys::MouseWheelAxis));
+
+  m_Input.bKeyboard = ControllerInput();
+  if (!m_Input.bKeyboard)
+    return;
+
+  m_Input.KeyShift = PlayerController->IsInputKeyDown(EKeys::LeftShift) || PlayerController->IsInputKeyDown(EKeys::RightShift);
+  m_Input.KeyCtrl = PlayerController->IsInputKeyDown(EKeys::LeftControl) || PlayerController->IsInputKeyDown(EKeys::RightControl);
+  m_Input.KeyAlt = PlayerController->IsInputKeyDown(EKeys::LeftAlt) || PlayerController->IsInputKeyDown(EKeys::RightAlt);
+  m_Input.KeysDown.Reset();
 
   TArray<FKey> Keys;
   EKeys::GetAllKeys(Keys);
   for (int i = 0; i < Keys.Num(); i++)
   {
     const ImGuiKey m_ImGuiKey = FKeyToImGuiKey(Keys[i].GetFName());
-    if (PlayerController->IsInputKeyDown(Keys[i])) {
-      if (m_ImGuiKey != ImGuiKey_None) {
-        IO.AddKeyEvent(m_ImGuiKey, true);
-      }
-    } else {
-      IO.AddKeyEvent(m_ImGuiKey, false);
+    if (m_ImGuiKey != ImGuiKey_None && PlayerController->IsInputKeyDown(Keys[i])) {
+      m_Input.KeysDown.Add(m_ImGuiKey);
+      m_Input.KeysPressed.AddUnique(m_ImGuiKey);
     }
 
     if (Keys[i].IsTouch()) {
       float TouchY, TouchX;
       bool TouchPressed;
       PlayerController->GetInputTouchState(ETouchIndex::Touch1, TouchY, TouchX, TouchPressed);
-      IO.AddMousePosEvent(TouchX, TouchY);
-      IO.AddMouseButtonEvent(0, TouchPressed);
+      m_Input.MousePos = ImVec2(TouchX, TouchY);
+      m_Input.MouseDown[0] = TouchPressed;
+      m_Input.MouseClicked[0] |= TouchPressed;
       continue;
     }
 
@@ -319,9 +588,9 @@ void FDFX_Thread::ImGui_ImplUE_ProcessEvent()
       if (char_code)
       {
         int c = tolower((int)*char_code);
-        if (PlayerController->IsInputKeyDown(EKeys::LeftShift) || PlayerController->IsInputKeyDown(EKeys::RightShift))
+        if (m_Input.KeyShift)
           c = toupper(c);
-        IO.AddInputCharacter((ImWchar)c);
+        m_Input.Characters.Add((ImWchar)c);
       }
     }
   }
@@ -330,138 +599,180 @@ void FDFX_Thread::ImGui_ImplUE_ProcessEvent()
   //ExternalWindow();
 }
 
-void FDFX_Thread::ImGui_ImplUE_NewFrame()
+void FDFX_Thread::FInputFrame::ResetEvents()
 {
-  ImGuiIO& IO = GetImGuiIO();
-  
-  IO.DisplaySize = ImVec2(static_cast<float>(ViewportSize.X), static_cast<float>(ViewportSize.Y));
+  FMemory::Memzero(MouseClicked);
+  KeysPressed.Reset();
+  Characters.Reset();
+}
+
+void FDFX_Thread::ImGui_ImplUE_ApplyInput(ImGuiIO& IO, const FInputFrame& Input)
+{
+  IO.DisplaySize = Input.DisplaySize;
   IO.DisplayFramebufferScale = ImVec2(1, 1);
 
-  if (PlayerController)
-  {
-    PlayerController->GetMousePosition(IO.MousePos.x, IO.MousePos.y);
-    IO.MouseDown[0] = PlayerController->IsInputKeyDown(EKeys::LeftMouseButton);
-    IO.MouseDown[1] = PlayerController->IsInputKeyDown(EKeys::RightMouseButton);
-    IO.MouseDown[2] = PlayerController->IsInputKeyDown(EKeys::MiddleMouseButton);
+  IO.AddMousePosEvent(Input.MousePos.x, Input.MousePos.y);
+  for (int Button = 0; Button < 3; Button++) {
+    if (Input.MouseClicked[Button] && !Input.MouseDown[Button]) {
+      IO.AddMouseButtonEvent(Button, true);
+    }
+    IO.AddMouseButtonEvent(Button, Input.MouseDown[Button]);
   }
 
-  //TODO : Add MouseWheelAxis
-  //io.AddMouseWheelEvent(0.f, PlayerController->IsInputKeyDown(EKeys::MouseWheelAxis));
+  if (!Input.bKeyboard)
+    return;
+
+  IO.KeyShift = Input.KeyShift;
+  IO.KeyCtrl = Input.KeyCtrl;
+  IO.KeyAlt = Input.KeyAlt;
+  IO.KeySuper = false;
+  for (const ImGuiKey Key : Input.KeysPressed) {
+    if (!Input.KeysDown.Contains(Key)) {
+      IO.AddKeyEvent(Key, true);
+    }
+  }
+  // Keyboard and gamepad keys, mouse keys are aliases fed by the mouse events above.
+  for (int Key = ImGuiKey_NamedKey_BEGIN; Key < ImGuiKey_MouseLeft; Key++) {
+    IO.AddKeyEvent(static_cast<ImGuiKey>(Key), Input.KeysDown.Contains(static_cast<ImGuiKey>(Key)));
+  }
+  for (const ImWchar Character : Input.Characters) {
+    IO.AddInputCharacter(Character);
+  }
+}
+
+void FDFX_Thread::ImGui_ImplUE_NewFrame()
+{
+  // Game thread side of a build, the previous build is done so the context and the UI statics are ours.
+  ImGui_ImplUE_UpdateFontAtlas();
+  FDFX_StatData::PrepareDFoundryFX(GameViewport);
+  PrepareOverlayBudget();
+
+  m_BuildInput = m_Input;
+  m_Input.ResetEvents();
+  const uint64 ImGuiThreadTime = m_ImGuiDiffTime;
+  m_UIBuildTask = Async(EAsyncExecution::TaskGraph, [this, ImGuiThreadTime]()
+  {
+    ImGui_ImplUE_BuildFrame(ImGuiThreadTime);
+  });
+}
+
+void FDFX_Thread::ImGui_ImplUE_BuildFrame(uint64 ImGuiThreadTime)
+{
+  const uint64 BuildBeginTime = FPlatformTime::Cycles64();
+  ImGuiIO& IO = GetImGuiIO();
+  ImGui_ImplUE_ApplyInput(IO, m_BuildInput);
+  FDFX_StatData::SampleDFoundryFX(ImGuiThreadTime * 1000, m_UIBuildTime);
 
   ImGui::NewFrame();
+  FDFX_StatData::RunDFoundryFX();
+  { 
+    SCOPE_CYCLE_COUNTER(STAT_ThreadRender);
+    ImGui::Render();
+    m_DrawData.GetWriteBuffer().CopyFrom(ImGui::GetDrawData());
+    m_DrawData.GetWriteBuffer().FontTexture = IO.Fonts->TexID;
+    m_DrawData.GetWriteBuffer().bMainWindowOpen = FDFX_StatData::bMainWindowOpen;
+    m_DrawData.GetWriteBuffer().bDisableGameControls = FDFX_StatData::bDisableGameControls;
+    // Set before publishing, the game thread reads it once it acquires this frame.
+    m_UIBuildTime = FPlatformTime::Cycles64() - BuildBeginTime;
+    m_DrawData.Publish();
+  }
+}
+
+void FDFX_Thread::ImGui_ImplUE_SampleOnly()
+{
+  // Suspended overlay: no ImGui frame, but the collector samples still reach the history, percentiles,
+  // hitch log and pacing so nothing is missing once the overlay comes back.
+  const uint64 ImGuiThreadTime = m_ImGuiDiffTime;
+  const uint64 UIBuildTime = m_UIBuildTime;
+  PrepareOverlayBudget();
+  m_UIBuildTask = Async(EAsyncExecution::TaskGraph, [ImGuiThreadTime, UIBuildTime]()
+  {
+    FDFX_StatData::SampleDFoundryFX(ImGuiThreadTime * 1000, UIBuildTime);
+  });
+}
+
+void FDFX_Thread::WaitUIBuildTask()
+{
+  if (m_UIBuildTask.IsValid()) {
+    m_UIBuildTask.Wait();
+  }
 }
 
-void FDFX_Thread::ImGui_ImplUE_RenderDrawLists()
+void FDFX_Thread::ImGui_ImplUE_RenderDrawLists(UCanvas* Canvas, bool bOverlayTarget)
 {
   // Avoid rendering when minimized
-  ImGuiIO& IO = GetImGuiIO();
-  int Fb_Width = static_cast<int>(IO.DisplaySize.x * IO.DisplayFramebufferScale.x);
-  int Fb_Height = static_cast<int>(IO.DisplaySize.y * IO.DisplayFramebufferScale.y);
-  if ((Fb_Width == 0) || (Fb_Height == 0))
+  FDFX_DrawDataSnapshot& Snapshot = m_DrawData.GetReadBuffer();
+  ImDrawData* draw_data = &Snapshot.DrawData;
+  int Fb_Width = static_cast<int>(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+  int Fb_Height = static_cast<int>(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+  if (!draw_data->Valid || (Fb_Width == 0) || (Fb_Height == 0))
     return;
 
-  ImDrawData* draw_data = ImGui::GetDrawData();
-  draw_data->ScaleClipRects(IO.DisplayFramebufferScale);
+  // Clip rects are converted to scissor rects (including FramebufferScale) by the renderer.
+  if (FDFX_StatData::StressPlotPoints != m_StressPlotValidated) {
+    m_StressPlotValidated = FDFX_StatData::StressPlotPoints;
+    m_StressPlotValidateIn = m_StressPlotValidated > 0 ? 3 : 0;
+  }
+  if (m_StressPlotValidateIn > 0 && --m_StressPlotValidateIn == 0) {
+    m_Renderer.ValidateNextFrame();
+  }
+  m_Renderer.BeginFrame(bOverlayTarget);
+  m_Renderer.Render(draw_data, Canvas, Snapshot.Owners.GetData());
+}
 
-  // Render command lists
-  for (int n = 0; n < draw_data->CmdListsCount; n++)
-  {
-    const ImDrawList* Cmd_List = draw_data->CmdLists[n];
-    const ImDrawVert* vtx_buffer = Cmd_List->VtxBuffer.Data;
-    const ImDrawIdx* Idx_Buffer = Cmd_List->IdxBuffer.Data;
+void FDFX_Thread::ImGui_ImplUE_RenderOverlayTarget()
+{
+  const int32 SizeX = static_cast<int32>(ViewportSize.X);
+  const int32 SizeY = static_cast<int32>(ViewportSize.Y);
+  if (SizeX <= 0 || SizeY <= 0)
+    return;
 
-    for (int cmd_i = 0; cmd_i < Cmd_List->CmdBuffer.Size; cmd_i++)
-    {
-      const ImDrawCmd* pcmd = &Cmd_List->CmdBuffer[cmd_i];
-      TArray<FCanvasUVTri> triangles;
-      for (unsigned int elem = 0; elem < pcmd->ElemCount / 3; elem++)
-      {
-        ImDrawVert v[] =
-        {
-          Cmd_List->VtxBuffer[Idx_Buffer[elem * 3]],
-          Cmd_List->VtxBuffer[Idx_Buffer[elem * 3 + 1]],
-          Cmd_List->VtxBuffer[Idx_Buffer[elem * 3 + 2]]
-        };
-
-        ImVec4 Col[] =
-        {
-          ImGui::ColorConvertU32ToFloat4(v[0].col),
-          ImGui::ColorConvertU32ToFloat4(v[1].col),
-          ImGui::ColorConvertU32ToFloat4(v[2].col)
-        };
-
-        ImVec2 min_pos = v[0].pos;
-        ImVec2 max_pos = v[0].pos;
-        for (int i = 0; i < 3; i++)
-        {
-          if (v[i].pos.x < min_pos.x)
-            min_pos.x = v[i].pos.x;
-          if (v[i].pos.y < min_pos.y)
-            min_pos.y = v[i].pos.y;
-          if (v[i].pos.x > max_pos.x)
-            max_pos.x = v[i].pos.x;
-          if (v[i].pos.y > max_pos.y)
-            max_pos.y = v[i].pos.y;
-        }
-
-        ImVec2 min_uv = v[0].uv;
-        ImVec2 max_uv = v[0].uv;
-        for (int i = 0; i < 3; i++)
-        {
-          if (v[i].uv.x < min_uv.x)
-            min_uv.x = v[i].uv.x;
-          if (v[i].uv.y < min_uv.y)
-            min_uv.y = v[i].uv.y;
-          if (v[i].uv.x > max_uv.x)
-            max_uv.x = v[i].uv.x;
-          if (v[i].uv.y > max_uv.y)
-            max_uv.y = v[i].uv.y;
-        }
-
-        for (int i = 0; i < 3; i++)
-        {
-          if (v[i].pos.x < pcmd->ClipRect.x)
-          {
-            v[i].uv.x += (max_uv.x - v[i].uv.x) * (pcmd->ClipRect.x - v[i].pos.x) / (max_pos.x - v[i].pos.x);
-            v[i].pos.x = pcmd->ClipRect.x;
-          }
-          else if (v[i].pos.x > pcmd->ClipRect.z)
-          {
-            v[i].uv.x -= (v[i].uv.x - min_uv.x) * (v[i].pos.x - pcmd->ClipRect.z) / (v[i].pos.x - min_pos.x);
-            v[i].pos.x = pcmd->ClipRect.z;
-          }
-          if (v[i].pos.y < pcmd->ClipRect.y)
-          {
-            v[i].uv.y += (max_uv.y - v[i].uv.y) * (pcmd->ClipRect.y - v[i].pos.y) / (max_pos.y - v[i].pos.y);
-            v[i].pos.y = pcmd->ClipRect.y;
-          }
-          else if (v[i].pos.y > pcmd->ClipRect.w)
-          {
-            v[i].uv.y -= (v[i].uv.y - min_uv.y) * (v[i].pos.y - pcmd->ClipRect.w) / (v[i].pos.y - min_pos.y);
-            v[i].pos.y = pcmd->ClipRect.w;
-          }
-        }
-
-        FCanvasUVTri triangle;
-        triangle.V0_Pos = FVector2D(v[0].pos.x, v[0].pos.y);
-        triangle.V1_Pos = FVector2D(v[1].pos.x, v[1].pos.y);
-        triangle.V2_Pos = FVector2D(v[2].pos.x, v[2].pos.y);
-        triangle.V0_UV = FVector2D(v[0].uv.x, v[0].uv.y);
-        triangle.V1_UV = FVector2D(v[1].uv.x, v[1].uv.y);
-        triangle.V2_UV = FVector2D(v[2].uv.x, v[2].uv.y);
-        triangle.V0_Color = FLinearColor(Col[0].x, Col[0].y, Col[0].z, Col[0].w);
-        triangle.V1_Color = FLinearColor(Col[1].x, Col[1].y, Col[1].z, Col[1].w);
-        triangle.V2_Color = FLinearColor(Col[2].x, Col[2].y, Col[2].z, Col[2].w);
-        triangles.Push(triangle);
-      }
+  if (!m_OverlayTarget) {
+    m_OverlayTarget = NewObject<UTextureRenderTarget2D>();
+    m_OverlayTarget->RenderTargetFormat = RTF_RGBA8;
+    m_OverlayTarget->bForceLinearGamma = true; // Store ImGui colors untouched, like the back buffer path.
+    m_OverlayTarget->ClearColor = FLinearColor::Transparent;
+    m_OverlayTarget->AddToRoot();
+  }
+  if (m_OverlayTarget->SizeX != SizeX || m_OverlayTarget->SizeY != SizeY) {
+    m_OverlayTarget->InitAutoFormat(SizeX, SizeY);
+  }
 
-      // Draw triangles
-      uCanvas->K2_DrawMaterialTriangle(FDFX_Module::MaterialInstance, triangles);
-      Idx_Buffer += pcmd->ElemCount;
-    }
+  // The target ends up premultiplied: color * alpha, with the accumulated coverage in alpha.
+  UKismetRenderingLibrary::ClearRenderTarget2D(uWorld, m_OverlayTarget, FLinearColor::Transparent);
+  UCanvas* TargetCanvas = nullptr;
+  FVector2D TargetSize;
+  FDrawToRenderTargetContext Context;
+  UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(uWorld, m_OverlayTarget, TargetCanvas, TargetSize, Context);
+  if (TargetCanvas) {
+    ImGui_ImplUE_RenderDrawLists(TargetCanvas, true);
+  }
+  UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(uWorld, Context);
+}
+
+void FDFX_Thread::ImGui_ImplUE_CompositeOverlay()
+{
+  if (!m_OverlayTarget || !uCanvas)
+    return;
+
+  FCanvasTileItem Tile(FVector2D::ZeroVector, m_OverlayTarget->GetResource(), FVector2D(m_OverlayTarget->SizeX, m_OverlayTarget->SizeY), FLinearColor::White);
+  Tile.BlendMode = SE_BLEND_AlphaComposite;
+  uCanvas->DrawItem(Tile);
+}
+
+void FDFX_Thread::ReleaseOverlayTarget()
+{
+  if (m_OverlayTarget) {
+    m_OverlayTarget->RemoveFromRoot();
+    m_OverlayTarget = nullptr;
   }
 }
 
+void FDFX_Thread::BenchmarkRenderer(int32 Frames)
+{
+  m_Renderer.StartBenchmark(Frames);
+}
+
 const char* FDFX_Thread::ImGui_ImplUE_GetClipboardText(void* user_data)
 {
 // Removed for Android builds
@@ -490,21 +801,25 @@ bool FDFX_Thread::ControllerInput()
 {
   static bool bControllerDisabled = false;
   static bool bMainWindowStillOpen = false;
+  // Settings of the last acquired frame, the UI build may be writing the statics.
+  const FDFX_DrawDataSnapshot& Settings = m_DrawData.GetReadBuffer();
+  const bool bMainWindowOpen = Settings.bMainWindowOpen;
+  const bool bDisableGameControls = Settings.bDisableGameControls;
   if (APawn* aPawn = PlayerController->GetPawn(); aPawn)
   {
     
 
-    if (!FDFX_StatData::bMainWindowOpen && !bMainWindowStillOpen)
+    if (!bMainWindowOpen && !bMainWindowStillOpen)
       return false;
 
-    if (!FDFX_StatData::bMainWindowOpen && bControllerDisabled) {
+    if (!bMainWindowOpen && bControllerDisabled) {
       aPawn->EnableInput(PlayerController);
       bControllerDisabled = false;
       bMainWindowStillOpen = false;
       return true;
     }
 
-    if (FDFX_StatData::bMainWindowOpen && !FDFX_StatData::bDisableGameControls) {
+    if (bMainWindowOpen && !bDisableGameControls) {
       if (aPawn) {
         aPawn->EnableInput(PlayerController);
       }
@@ -512,8 +827,8 @@ bool FDFX_Thread::ControllerInput()
       return true;
     }
 
-    if (FDFX_StatData::bDisableGameControls) {
-      if (FDFX_StatData::bMainWindowOpen) {
+    if (bDisableGameControls) {
+      if (bMainWindowOpen) {
         aPawn->DisableInput(PlayerController);
         bMainWindowStillOpen = true;
         bControllerDisabled = true;
@@ -585,6 +900,7 @@ void FDFX_Thread::Stop()
   bStopping = true;
 
   RemoveDelegates();
+  WaitUIBuildTask();
 
   DFoundryFX_Thread->WaitForCompletion();
 
@@ -616,7 +932,7 @@ void FDFX_Thread::RemoveDelegates() {
     hOnGameModeInitialized.Reset();
   }
   if (hOnPipelineStateLogged.IsValid()) {
-    //FPipelineFileCacheManager::OnPipelineStateLogged().Remove(hOnPipelineStateLogged);
+    FPipelineFileCacheManager::OnPipelineStateLogged().Remove(hOnPipelineStateLogged);
     hOnPipelineStateLogged.Reset();
   }
   if (hOnWorldBeginPlay.IsValid()) {
@@ -635,13 +951,34 @@ void FDFX_Thread::Wait(float Seconds)
 
 void FDFX_Thread::Tick()
 {
+  // Platforms without multithreading tick the runnable from the game thread, once per frame.
+  if (!bPaused) {
+    CollectFrame();
+  }
 }
 
 uint32 FDFX_Thread::Run()
 {
+  // Fixed-cadence collector: every CollectorIntervalMs, one sample per frame clock published by the game thread.
+  while (!bStopping)
+  {
+    if (bPaused) {
+      bIsVerifiedSuspended.AtomicSet(true);
+      Wait(0.01f);
+      continue;
+    }
+    CollectFrame();
+    Wait(FDFX_StatData::CollectorIntervalMs / 1000.f);
+  }
+  bHasStopped.AtomicSet(true);
   return 0;
 }
 
+void FDFX_Thread::CollectFrame()
+{
+  FDFX_StatData::CollectFrameSamples();
+}
+
 void FDFX_Thread::Exit()
 {
 }
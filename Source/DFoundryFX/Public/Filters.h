@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Percentiles.h"
+
+enum class EDFX_Filter : uint8 {
+  Raw,
+  EMA,
+  Mean,
+  Median,
+  Num
+};
+
+// Smoothing of one metric, defined in seconds rather than samples so it behaves the same at any frame rate.
+// Every filter is kept up to date on each Add, switching modes never restarts from zero:
+// - EMA with time constant Tau, alpha = 1 - exp(-dt / Tau), O(1).
+// - Mean and median of the samples of the last Window seconds. The samples are kept in a ring with a running sum,
+//   and their log bucket (see FDFX_LogHistogram) in a Fenwick tree, so the median is found in O(log buckets)
+//   within 1%. At most MaxSamples are kept, a longer window is cut short at high frame rates.
+class FDFX_MetricFilter
+{
+public:
+  static constexpr int32 MaxSamples = 2048;
+
+  FDFX_MetricFilter() { Ring.SetNumUninitialized(MaxSamples); Reset(); }
+
+  float Add(double Time, double DeltaTime, float Value, EDFX_Filter Mode, float TimeConstant, float Window)
+  {
+    // EMA
+    if (!bPrimed || TimeConstant <= 0.f) {
+      Average = Value;
+      bPrimed = true;
+    } else if (DeltaTime > 0) {
+      Average += (Value - Average) * (1.0 - FMath::Exp(-DeltaTime / TimeConstant));
+    }
+
+    // Window
+    while (Count > 0 && (Count == MaxSamples || Ring[Tail()].Time <= Time - Window)) {
+      const FEntry& Oldest = Ring[Tail()];
+      Sum -= Oldest.Value;
+      AddBucket(Oldest.Bucket, -1);
+      Count--;
+    }
+    FEntry& Entry = Ring[Head];
+    Entry.Time = Time;
+    Entry.Value = Value;
+    Entry.Bucket = static_cast<uint16>(FDFX_LogHistogram::BucketOf(Value));
+    Sum += Value;
+    AddBucket(Entry.Bucket, 1);
+    Head = Head + 1 < MaxSamples ? Head + 1 : 0;
+    Count++;
+    if (Count == 1) {
+      Sum = Value;  // drop the rounding left by the previous samples
+    }
+
+    switch (Mode)
+    {
+    case EDFX_Filter::EMA:    return static_cast<float>(Average);
+    case EDFX_Filter::Mean:   return static_cast<float>(Sum / Count);
+    case EDFX_Filter::Median: return static_cast<float>(FDFX_LogHistogram::ValueOf(FindBucket((Count + 1) / 2)));
+    default:                  return Value;
+    }
+  }
+
+  void Reset()
+  {
+    Head = 0;
+    Count = 0;
+    Sum = 0;
+    Average = 0;
+    bPrimed = false;
+    FMemory::Memzero(Tree);
+  }
+
+private:
+  static constexpr int32 TreeSize = 1024;
+  static_assert(TreeSize >= FDFX_LogHistogram::NumBuckets, "The Fenwick tree must cover every histogram bucket.");
+
+  struct FEntry {
+    double Time;
+    float Value;
+    uint16 Bucket;
+  };
+  int32 Tail() const { return (Head + MaxSamples - Count) % MaxSamples; }
+
+  void AddBucket(int32 Bucket, int32 Delta)
+  {
+    for (int32 i = Bucket + 1; i <= TreeSize; i += i & -i) {
+      Tree[i] += Delta;
+    }
+  }
+  // Bucket holding the Rank-th smallest sample, by descending the tree.
+  int32 FindBucket(int32 Rank) const
+  {
+    int32 Position = 0;
+    for (int32 Step = TreeSize; Step > 0; Step >>= 1) {
+      if (Position + Step <= TreeSize && Tree[Position + Step] < Rank) {
+        Position += Step;
+        Rank -= Tree[Position];
+      }
+    }
+    return FMath::Min(Position, FDFX_LogHistogram::NumBuckets - 1);
+  }
+
+  TArray<FEntry> Ring;
+  int32 Head = 0;
+  int32 Count = 0;
+  double Sum = 0;
+  double Average = 0;
+  bool bPrimed = false;
+  int32 Tree[TreeSize + 1];
+};
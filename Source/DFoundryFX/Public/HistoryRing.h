@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+
+// Struct-of-arrays ring of the latest Capacity rows: one time column and any number of float value columns,
+// all sharing a single Head and Count. Every row is written twice, at Head and Head + Capacity, so each column is
+// contiguous and oldest first from its Get pointer: any range of rows can be handed to ImPlot as is.
+// Times are float seconds relative to a base kept by the owner, Rebase moves them when the base moves.
+class FDFX_HistoryRing
+{
+public:
+  FDFX_HistoryRing(int32 InCapacity, int32 InNumColumns)
+  {
+    Resize(InCapacity);
+    for (int32 c = 0; c < InNumColumns; c++) {
+      AddColumn();
+    }
+  }
+
+  // New column, zero for the rows already in the ring.
+  int32 AddColumn()
+  {
+    Columns.AddDefaulted_GetRef().SetNumZeroed(Capacity * 2);
+    Pending.Add(0.f);
+    return Columns.Num() - 1;
+  }
+  int32 NumColumns() const { return Columns.Num(); }
+
+  // Value of Column for the next Add, a column that is not set again repeats its previous value.
+  void Set(int32 Column, float Value) { Pending[Column] = Value; }
+  void Add(float Time)
+  {
+    Times[Head] = Times[Head + Capacity] = Time;
+    for (int32 c = 0; c < Columns.Num(); c++) {
+      float* Data = Columns[c].GetData();
+      Data[Head] = Data[Head + Capacity] = Pending[c];
+    }
+    Head = Head + 1 < Capacity ? Head + 1 : 0;
+    if (Count < Capacity) Count++;
+  }
+
+  int32 Num() const { return Count; }
+  int32 GetCapacity() const { return Capacity; }
+  const float* GetTimes() const { return Times.GetData() + Start(); }
+  const float* Get(int32 Column) const { return Columns[Column].GetData() + Start(); }
+  float Last(int32 Column) const { return Columns[Column][Head + Capacity - 1]; }
+
+  // Rows [OutStart, OutStart + OutCount) hold the times at or after MinTime, plus the row before
+  // so a line enters the plot from its left edge.
+  void FindRange(float MinTime, int32& OutStart, int32& OutCount) const
+  {
+    const TArrayView<const float> View(GetTimes(), Count);
+    OutStart = FMath::Max(Algo::LowerBound(View, MinTime) - 1, 0);
+    OutCount = Count - OutStart;
+  }
+
+  // Keeps the newest rows that fit, only called when the capacity actually changes.
+  void Resize(int32 NewCapacity)
+  {
+    const int32 Keep = FMath::Min(Count, NewCapacity);
+    ResizeColumn(Times, NewCapacity, Keep);
+    for (TArray<float>& Column : Columns) {
+      ResizeColumn(Column, NewCapacity, Keep);
+    }
+    Capacity = NewCapacity;
+    Count = Keep;
+    Head = Keep % NewCapacity;
+  }
+  void Rebase(float Delta)
+  {
+    for (float& Time : Times) {
+      Time -= Delta;
+    }
+  }
+  void Erase()
+  {
+    Head = 0;
+    Count = 0;
+  }
+
+private:
+  int32 Start() const { return (Head + Capacity - Count) % Capacity; }
+  void ResizeColumn(TArray<float>& Column, int32 NewCapacity, int32 Keep) const
+  {
+    TArray<float> NewColumn;
+    NewColumn.SetNumZeroed(NewCapacity * 2);
+    if (Keep > 0) {
+      const float* Oldest = Column.GetData() + Start() + Count - Keep;
+      FMemory::Memcpy(NewColumn.GetData(), Oldest, Keep * sizeof(float));
+      FMemory::Memcpy(NewColumn.GetData() + NewCapacity, Oldest, Keep * sizeof(float));
+    }
+    Column = MoveTemp(NewColumn);
+  }
+
+  int32 Capacity = 0;
+  int32 Count = 0;
+  int32 Head = 0;
+  TArray<float> Times;
+  TArray<TArray<float>> Columns;
+  TArray<float> Pending;
+};
@@ -24,9 +24,16 @@ public:
   virtual void StartupModule() override;
   virtual void ShutdownModule() override;
   virtual bool IsGameModule() const override { return true; }
+#if WITH_EDITOR
+  static UMaterialInterface* CreateMaterialAlpha8(UMaterialInterface* Source);
+#endif
 
   static inline UMaterialInterface* MasterMaterial = nullptr;
-  static inline UMaterialInstanceDynamic* MaterialInstance = nullptr;
+  static inline UMaterialInstanceDynamic* MaterialInstance = nullptr; // Active permutation, matches the FontTexture format.
+  static inline UMaterialInstanceDynamic* MaterialInstanceRGBA32 = nullptr;
+  // M_ImGui_A8 permutation: M_ImGui reading coverage from the R channel of a PF_G8 atlas. Editor builds create it when missing.
+  static inline UMaterialInterface* MasterMaterialAlpha8 = nullptr;
+  static inline UMaterialInstanceDynamic* MaterialInstanceAlpha8 = nullptr;
   static inline UTexture2D* FontTexture = nullptr;
   static inline bool FontTexture_Updated = false;
 };
\ No newline at end of file
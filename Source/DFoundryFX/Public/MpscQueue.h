@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Bounded lock-free queue, any number of producer threads and one consumer. Records are copied into a fixed ring
+// allocated with the queue, so Enqueue never allocates. Each cell carries a sequence number telling whether it
+// is free for the producer that claimed its position or filled for the consumer. Enqueue fails when the ring is full.
+template <typename T, uint32 Capacity>
+class TDFX_MpscQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "TDFX_MpscQueue capacity must be a power of two.");
+
+public:
+  TDFX_MpscQueue()
+  {
+    for (uint32 i = 0; i < Capacity; i++) {
+      Cells[i].Sequence.Store(i);
+    }
+  }
+
+  // Any thread.
+  bool Enqueue(const T& Value)
+  {
+    uint32 Position = EnqueuePosition.Load(EMemoryOrder::Relaxed);
+    for (;;)
+    {
+      FCell& Cell = Cells[Position & (Capacity - 1)];
+      const int32 Diff = static_cast<int32>(Cell.Sequence.Load() - Position);
+      if (Diff == 0) {
+        // The cell is free, claim the position. On failure Position is reloaded by CompareExchange.
+        if (EnqueuePosition.CompareExchange(Position, Position + 1)) {
+          Cell.Value = Value;
+          Cell.Sequence.Store(Position + 1);
+          return true;
+        }
+      } else if (Diff < 0) {
+        // The consumer has not released this cell yet, the ring is full.
+        return false;
+      } else {
+        Position = EnqueuePosition.Load(EMemoryOrder::Relaxed);
+      }
+    }
+  }
+
+  // Consumer thread only.
+  bool Dequeue(T& OutValue)
+  {
+    FCell& Cell = Cells[DequeuePosition & (Capacity - 1)];
+    if (static_cast<int32>(Cell.Sequence.Load() - (DequeuePosition + 1)) < 0)
+      return false;
+
+    OutValue = Cell.Value;
+    Cell.Sequence.Store(DequeuePosition + Capacity);
+    DequeuePosition++;
+    return true;
+  }
+
+private:
+  struct FCell {
+    TAtomic<uint32> Sequence;
+    T Value;
+  };
+  FCell Cells[Capacity];
+  alignas(PLATFORM_CACHE_LINE_SIZE) TAtomic<uint32> EnqueuePosition { 0 };
+  alignas(PLATFORM_CACHE_LINE_SIZE) uint32 DequeuePosition = 0;
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Histogram with logarithmic buckets, 2% wide from 0.01 to 10000 (ms), so any quantile is known within 1%
+// whatever the distribution. Bucket 0 takes everything below the range and the last bucket everything above.
+class FDFX_LogHistogram
+{
+public:
+  static constexpr int32 NumBuckets = 700;
+
+  static int32 BucketOf(double Value)
+  {
+    if (!(Value > MinValue))
+      return 0;
+    return FMath::Min(1 + FMath::FloorToInt(FMath::Loge(Value / MinValue) * InvLogBase), NumBuckets - 1);
+  }
+  // Lowest value of the bucket, the upper edge is the lower edge of the next one.
+  static double LowerEdgeOf(int32 Bucket)
+  {
+    return Bucket == 0 ? 0.0 : MinValue * FMath::Pow(Base, Bucket - 1);
+  }
+  // Geometric centre of the bucket.
+  static double ValueOf(int32 Bucket)
+  {
+    return Bucket == 0 ? MinValue : MinValue * FMath::Pow(Base, Bucket - 0.5);
+  }
+
+  void Add(int32 Bucket) { Counts[Bucket]++; Total++; }
+  void Remove(int32 Bucket) { Counts[Bucket]--; Total--; }
+  void Reset() { FMemory::Memzero(Counts); Total = 0; }
+  uint64 GetTotal() const { return Total; }
+  uint32 GetCount(int32 Bucket) const { return Counts[Bucket]; }
+
+  // Value at each of the ascending Quantiles (0..1), in one pass over the buckets.
+  void GetQuantiles(const double* Quantiles, int32 Num, double* OutValues) const
+  {
+    uint64 Cumulative = 0;
+    int32 Bucket = 0;
+    for (int32 i = 0; i < Num; i++)
+    {
+      const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(Quantiles[i] * Total)));
+      while (Bucket < NumBuckets && Cumulative + Counts[Bucket] < Rank) {
+        Cumulative += Counts[Bucket];
+        Bucket++;
+      }
+      OutValues[i] = Total > 0 ? ValueOf(FMath::Min(Bucket, NumBuckets - 1)) : 0.0;
+    }
+  }
+
+private:
+  static constexpr double MinValue = 0.01;
+  static constexpr double Base = 1.02;
+  static constexpr double InvLogBase = 50.498;  // 1 / ln(1.02)
+
+  uint32 Counts[NumBuckets] = {};
+  uint64 Total = 0;
+};
+
+// P50/P95/P99/P99.9 of NumChannels values, over the last WindowSeconds and over the whole session.
+// Add is O(1) per sample (amortized: every sample leaves the window once), Update walks the histograms
+// and is meant to run at UI rate.
+template <int32 NumChannels>
+class TDFX_PercentileTracker
+{
+public:
+  struct FQuantiles {
+    float P50;
+    float P95;
+    float P99;
+    float P999;
+  };
+
+  TDFX_PercentileTracker(double InWindowSeconds, int32 InMaxWindowSamples)
+    : WindowSeconds(InWindowSeconds)
+  {
+    Ring.SetNumUninitialized(InMaxWindowSamples);
+    Reset();
+  }
+
+  void Add(double Time, const double* Values)
+  {
+    // Drop the samples that left the window, or the oldest one when the ring is full.
+    while (Count > 0 && (Count == Ring.Num() || Ring[Tail()].Time < Time - WindowSeconds)) {
+      const FEntry& Oldest = Ring[Tail()];
+      for (int32 c = 0; c < NumChannels; c++) {
+        Window[c].Remove(Oldest.Buckets[c]);
+      }
+      Count--;
+    }
+
+    FEntry& Entry = Ring[Head];
+    Entry.Time = Time;
+    for (int32 c = 0; c < NumChannels; c++) {
+      const int32 Bucket = FDFX_LogHistogram::BucketOf(Values[c]);
+      Entry.Buckets[c] = static_cast<uint16>(Bucket);
+      Window[c].Add(Bucket);
+      Session[c].Add(Bucket);
+    }
+    Head = Head + 1 < Ring.Num() ? Head + 1 : 0;
+    Count++;
+  }
+
+  void Update()
+  {
+    static const double Quantiles[4] = { 0.5, 0.95, 0.99, 0.999 };
+    double Values[4];
+    for (int32 c = 0; c < NumChannels; c++) {
+      Window[c].GetQuantiles(Quantiles, 4, Values);
+      WindowQuantiles[c] = { float(Values[0]), float(Values[1]), float(Values[2]), float(Values[3]) };
+      Session[c].GetQuantiles(Quantiles, 4, Values);
+      SessionQuantiles[c] = { float(Values[0]), float(Values[1]), float(Values[2]), float(Values[3]) };
+    }
+  }
+
+  void Reset()
+  {
+    Head = 0;
+    Count = 0;
+    for (int32 c = 0; c < NumChannels; c++) {
+      Window[c].Reset();
+      Session[c].Reset();
+      WindowQuantiles[c] = {};
+      SessionQuantiles[c] = {};
+    }
+  }
+
+  const FQuantiles& GetWindow(int32 Channel) const { return WindowQuantiles[Channel]; }
+  const FQuantiles& GetSession(int32 Channel) const { return SessionQuantiles[Channel]; }
+  const FDFX_LogHistogram& GetWindowHistogram(int32 Channel) const { return Window[Channel]; }
+  const FDFX_LogHistogram& GetSessionHistogram(int32 Channel) const { return Session[Channel]; }
+  int32 GetWindowCount() const { return Count; }
+  uint64 GetSessionCount() const { return Session[0].GetTotal(); }
+
+private:
+  struct FEntry {
+    double Time;
+    uint16 Buckets[NumChannels];
+  };
+  int32 Tail() const { return (Head + Ring.Num() - Count) % Ring.Num(); }
+
+  double WindowSeconds;
+  TArray<FEntry> Ring;
+  int32 Head = 0;
+  int32 Count = 0;
+  FDFX_LogHistogram Window[NumChannels];
+  FDFX_LogHistogram Session[NumChannels];
+  FQuantiles WindowQuantiles[NumChannels];
+  FQuantiles SessionQuantiles[NumChannels];
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CanvasTypes.h"
+#include "CanvasRender.h"
+#include "Engine/Canvas.h"
+#include "LocalVertexFactory.h"
+#include "RawIndexBuffer.h"
+#include "StaticMeshResources.h"
+#include "ImGui/imgui.h"
+#include <atomic>
+
+// One ImDrawCmd, with offsets into the frame vertex/index buffers and its ClipRect as a render target scissor.
+struct FDFX_DrawCmd {
+  FIntRect ScissorRect;
+  ImTextureID TextureId;
+  uint32 VtxOffset;
+  uint32 IdxOffset;
+  uint32 ElemCount;
+};
+
+// One ImDrawList of the snapshot, its vertices, indices and draw commands are ranges of the frame arrays.
+struct FDFX_DrawList {
+  const ImDrawList* Owner;
+  uint32 VtxOffset;
+  uint32 VtxCount;
+  uint32 IdxOffset;
+  uint32 IdxCount;
+  uint32 CmdOffset;
+  uint32 CmdCount;
+};
+
+// Converted geometry of each ImDrawList, keyed by list and validated by its content hash. Render thread only.
+struct FDFX_GeometryCache {
+  struct FEntry {
+    uint64 Hash = 0;
+    uint32 LastFrame = 0;
+    TArray<FVector3f> Positions;
+    TArray<FVector2f> UVs;
+    TArray<FColor> Colors;
+  };
+  TMap<const ImDrawList*, FEntry> Lists;
+  uint32 FrameCounter = 0;
+  double MissCyclesPerVertex = 0.0;
+};
+
+// Plugin owned copy of a finished ImDrawData, so the ImGui context can build the next frame while this one is drawn.
+// The copied lists are recycled and keep their high-water capacity, Owners keeps the context's lists as stable keys.
+struct FDFX_DrawDataSnapshot {
+  ~FDFX_DrawDataSnapshot();
+
+  ImDrawData DrawData;
+  TArray<ImDrawList*> Lists;
+  TArray<const ImDrawList*> Owners;
+  // Font atlas texture the frame was built with.
+  ImTextureID FontTexture = nullptr;
+  // UI settings of the frame, the game thread controls input from them.
+  bool bMainWindowOpen = false;
+  bool bDisableGameControls = true;
+
+  void CopyFrom(const ImDrawData* Src);
+  void Reset() { DrawData.Clear(); Owners.Reset(); }
+};
+
+// Snapshot of a whole ImDrawData frame: deep-copied on the game thread, converted and drawn on the render thread.
+// Instances are pooled by FDFX_Renderer: every array keeps its high-water capacity across frames.
+struct FDFX_RenderData {
+  FDFX_RenderData(ERHIFeatureLevel::Type InFeatureLevel, TSharedPtr<FDFX_GeometryCache> InGeometryCache)
+    : GeometryCache(InGeometryCache)
+    , VertexFactory(InFeatureLevel, "FDFX_RenderData")
+  {}
+  ~FDFX_RenderData() { ReleaseResources_RenderThread(); }
+
+  const FMaterialRenderProxy* MaterialRenderProxy = nullptr;
+  FCanvas::FTransformEntry Transform = FCanvas::FTransformEntry(FMatrix::Identity);
+  const FRenderTarget* RenderTarget = nullptr;
+  FGameTime Time;
+  bool bScaledToRenderTarget = false;
+  // Drawn into the cached overlay target: alpha accumulates coverage so the target can be composited premultiplied.
+  bool bOverlayTarget = false;
+  bool bValidate = false;
+
+  // Frame arena, the raw ImDrawData copy filled on the game thread.
+  TArray<ImDrawVert> Vertices;
+  TArray<ImDrawIdx> Indices;
+  TArray<FDFX_DrawCmd> DrawCmds;
+  TArray<FDFX_DrawList> DrawLists;
+  void ResetFrame() { Vertices.Reset(); Indices.Reset(); DrawCmds.Reset(); DrawLists.Reset(); }
+
+  // Converted vertex streams, filled on the render thread.
+  TSharedPtr<FDFX_GeometryCache> GeometryCache;
+  TArray<FVector3f> Positions;
+  TArray<FVector2f> UVs;
+  TArray<FColor> Colors;
+  // Hash of the frame held by the GPU buffers, they are only rebuilt when it changes.
+  uint64 UploadedHash = 0;
+  TArray<uint64> ListHashes;
+  uint64 HashCycles = 0;
+  uint64 HashFrame_RenderThread();
+  void ConvertVertices_RenderThread();
+
+  // GPU buffers, only reallocated when the frame outgrows them.
+  uint32 VertexCapacity = 0;
+  uint32 IndexCapacity = 0;
+  FStaticMeshVertexBuffers StaticMeshVertexBuffers;
+  FRawIndexBuffer IndexBuffer;
+  FLocalVertexFactory VertexFactory;
+  TArray<FMeshBatch> MeshBatches;
+
+  void InitResources_RenderThread(FRHICommandListImmediate& RHICmdList);
+  // Check the converted streams against the scalar kernel and every mesh batch against the buffers and the target,
+  // then log the result. Run after InitResources_RenderThread when bValidate is set.
+  bool Validate_RenderThread() const;
+  void ReleaseResources_RenderThread();
+  void RenderDrawCmds(FCanvasRenderContext& RenderContext, FMeshPassProcessorRenderState& DrawRenderState, const FSceneView& View);
+};
+
+// Canvas render item that draws a FDFX_RenderData with one indexed draw per ImDrawCmd.
+class FDFX_RenderItem : public FCanvasBaseRenderItem
+{
+public:
+  FDFX_RenderItem(TSharedPtr<FDFX_RenderData> InData) : Data(InData) {}
+  virtual ~FDFX_RenderItem() {}
+
+  virtual bool Render_RenderThread(FCanvasRenderContext& RenderContext, FMeshPassProcessorRenderState& DrawRenderState, const FCanvas* Canvas) override;
+  virtual bool Render_GameThread(const FCanvas* Canvas, FCanvasRenderThreadScope& RenderScope) override;
+
+private:
+  static const FSceneView& CreateView(FCanvasRenderContext& RenderContext, const FDFX_RenderData& InData);
+  TSharedPtr<FDFX_RenderData> Data;
+};
+
+class DFOUNDRYFX_API FDFX_Renderer
+{
+public:
+  ~FDFX_Renderer();
+
+  // Pick a free frame slot from the pool and reset it, called before each Render. bOverlayTarget when the frame is
+  // drawn into the cached overlay target rather than the back buffer.
+  void BeginFrame(bool bOverlayTarget = false);
+  // ListOwners optionally gives one geometry cache key per CmdLists entry, for draw data copied out of the context.
+  void Render(ImDrawData* DrawData, UCanvas* Canvas, const ImDrawList* const* ListOwners = nullptr);
+
+  // ImDrawVert to engine vertex streams (position, full precision UV, FColor), each vertex converted once.
+  // ConvertVertices uses SSE2/NEON when available, ConvertVertices_Scalar is the reference implementation.
+  static void ConvertVertices(const ImDrawVert* Src, int32 Num, FVector3f* OutPositions, FVector2f* OutUVs, FColor* OutColors);
+  static void ConvertVertices_Scalar(const ImDrawVert* Src, int32 Num, FVector3f* OutPositions, FVector2f* OutUVs, FColor* OutColors);
+  // Compare both kernels bit-for-bit on random vertices, used by DFoundryFX.VerifyVertexKernel.
+  static bool VerifyVertexKernel(int32 NumVertices);
+
+  // Validate the next drawn frame as submitted on the render thread, see FDFX_RenderData::Validate_RenderThread.
+  void ValidateNextFrame() { bValidateNextFrame = true; }
+
+  // Growth of the buffers owned by the overlay geometry path (arenas, frame pool, GPU buffers). This is not a heap
+  // allocation count: the render item and render command of every frame are allocated outside of it.
+  static inline FThreadSafeCounter BufferGrowthCount;
+  static inline TAtomic<int32> FrameBufferGrowths { 0 };
+  // Every allocation ImGui and ImPlot make, through FMemory. Installed before the contexts are created.
+  static inline FThreadSafeCounter ImGuiAllocationCount;
+  static inline TAtomic<int32> FrameImGuiAllocations { 0 };
+  static void InstallImGuiAllocator();
+
+  // Draw-data change detection: smoothed share of ImDrawLists reused from the geometry cache and estimated conversion
+  // time saved, net of the hashing and copy overhead. Written on the render thread, read by the UI build.
+  static inline std::atomic<float> GeometryCacheHitRate { 0.f };
+  static inline std::atomic<float> GeometryCacheSavedMs { 0.f };
+  static void RecordGeometryCache(int32 Hits, int32 Lookups, int32 ReusedVertices, double MissCyclesPerVertex, uint64 OverheadCycles);
+
+  // Alternate between batched and legacy paths for the next Frames and log the cost of both, on the game thread alone
+  // and up to the end of their render thread work. The GPU time is not included.
+  void StartBenchmark(int32 Frames);
+
+private:
+  TArray<TSharedPtr<FDFX_RenderData>> FramePool;
+  TSharedPtr<FDFX_RenderData> FrameData;
+  int32 LastBufferGrowthCount = 0;
+  int32 LastImGuiAllocationCount = 0;
+  TSharedPtr<FDFX_GeometryCache> GeometryCache = MakeShared<FDFX_GeometryCache>();
+  bool bValidateNextFrame = false;
+
+  void RenderBatched(ImDrawData* DrawData, UCanvas* Canvas, const ImDrawList* const* ListOwners);
+  void RenderLegacy(ImDrawData* DrawData, UCanvas* Canvas);
+
+  // Draw commands of any other texture than the font atlas are skipped, logged once per texture.
+  ImTextureID LastRejectedTexture = nullptr;
+  void RejectTexture(ImTextureID TextureId);
+
+  struct FBenchmarkSample {
+    uint64 Cycles = 0;
+    uint64 FlushedCycles = 0;
+    uint64 Triangles = 0;
+    int32 Frames = 0;
+  };
+  FBenchmarkSample BenchmarkBatched;
+  FBenchmarkSample BenchmarkLegacy;
+  int32 BenchmarkFramesLeft = 0;
+  void LogBenchmark();
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Single writer, any number of readers. The writer never waits: it makes the sequence odd, copies the value and
+// makes it even again. Readers copy the value and retry when the sequence was odd or changed meanwhile,
+// so they may spin while a write is in progress but can never delay it. T must be plain data.
+template <typename T>
+class TDFX_SeqLock
+{
+  static_assert(TIsPODType<T>::Value, "TDFX_SeqLock only publishes plain data.");
+
+public:
+  TDFX_SeqLock() { FMemory::Memzero(Value); }
+
+  // Writer thread only.
+  void Write(const T& InValue)
+  {
+    const uint32 Begin = Sequence.Load(EMemoryOrder::Relaxed);
+    Sequence.Store(Begin + 1);
+    FPlatformMisc::MemoryBarrier();
+    FMemory::Memcpy(&Value, &InValue, sizeof(T));
+    FPlatformMisc::MemoryBarrier();
+    Sequence.Store(Begin + 2);
+  }
+
+  // Any thread. OutRetries, when given, receives the number of torn copies that were thrown away.
+  T Read(uint32* OutRetries = nullptr) const
+  {
+    T Result;
+    uint32 Retries = 0;
+    for (;;)
+    {
+      const uint32 Begin = Sequence.Load();
+      if ((Begin & 1) == 0) {
+        FPlatformMisc::MemoryBarrier();
+        FMemory::Memcpy(&Result, &Value, sizeof(T));
+        FPlatformMisc::MemoryBarrier();
+        if (Sequence.Load() == Begin)
+          break;
+      }
+      Retries++;
+      FPlatformProcess::Yield();
+    }
+    if (OutRetries) {
+      *OutRetries = Retries;
+    }
+    return Result;
+  }
+
+  // Number of completed writes.
+  uint32 GetVersion() const { return Sequence.Load() / 2; }
+
+private:
+  TAtomic<uint32> Sequence { 0 };
+  T Value;
+};
\ No newline at end of file
@@ -12,14 +12,100 @@
 #include "ImGui/imgui.h"
 #include "ImGui/imgui_internal.h"
 #include "ImGui/implot.h"
+#include "Containers/CircularQueue.h"
+#include "Misc/SecureHash.h"
+#include "MpscQueue.h"
+#include "SeqLock.h"
+#include "Percentiles.h"
+#include "Filters.h"
+#include "HistoryRing.h"
 #include "Misc/App.h"
 #include "Stats/Stats2.h"
 #include "Stats/StatsData.h"
+#include <atomic>
 
 class DFOUNDRYFX_API FDFX_StatData
 {
 public:
-  static void RunDFoundryFX(UGameViewportClient* Viewport, uint64 ImGuiThreadTime);
+  // Game thread, before a UI build is launched: reads the viewport state the UI needs and runs its queued console commands.
+  static void PrepareDFoundryFX(UGameViewportClient* Viewport);
+  // UI build, off the game thread: only ImGui/ImPlot and the state captured by PrepareDFoundryFX.
+  static void RunDFoundryFX();
+  // Called by every UI build before RunDFoundryFX: drains the collector samples into the history.
+  // ImGuiThreadTime is the overlay game-thread cost, UIBuildTime the previous build cost, both in cycles.
+  static void SampleDFoundryFX(uint64 ImGuiThreadTime, uint64 UIBuildTime);
+
+  // Clock of one engine frame, published by the game thread once the frame ends so the number, time and delta always match.
+  struct FFrameClock {
+    uint64 FrameNumber;
+    double Time;
+    double DeltaTime;
+  };
+  // Game thread, end of frame (FCoreDelegates::OnEndFrame).
+  static void PublishFrameClock();
+
+  // Engine timings of one frame, read by the FDFX_Thread collector (producer) and drained by the UI (consumer).
+  struct FFrameSample {
+    double Time;
+    double DeltaTime;
+    uint64 FrameNumber;
+    float GameThreadTime;
+    float RenderThreadTime;
+    float GPUFrameTime;
+    float RHIThreadTime;
+    float SwapBufferTime;
+    float InputLatencyTime;
+    uint32 DrawCalls;
+    uint32 Primitives;
+    uint64 UsedPhysicalMemory;
+    uint64 UsedVirtualMemory;
+  };
+  static FFrameSample ReadFrameSample(const FFrameClock& Clock);
+  // Producer side, called by the collector: one sample for every frame clock published since the last call.
+  static void CollectFrameSamples();
+  static inline float CollectorIntervalMs = 1.0f;
+
+  // Metric channels of the filters, the long history and the percentiles.
+  enum EHistoryChannel : int {
+    ChannelFrame,
+    ChannelFPS,
+    ChannelGame,
+    ChannelRender,
+    ChannelGPU,
+    ChannelRHI,
+    ChannelSwap,
+    ChannelInput,
+    ChannelImGui,
+    ChannelNum
+  };
+
+  // Every metric of the overlay for the last sampled frame, times in ms (thread times smoothed).
+  // Written by UpdateStats and published through a seqlock: any thread can take a consistent copy without locking.
+  struct FFrameSnapshot {
+    uint64 FrameNumber;
+    int32  StatsFrame;
+    double Time;
+    double DeltaTime;
+    float  FrameTime;
+    int32  FramesPerSecond;
+    float  GameThreadTime;
+    float  RenderThreadTime;
+    float  GPUFrameTime;
+    float  RHIThreadTime;
+    float  SwapBufferTime;
+    float  InputLatencyTime;
+    float  ImGuiThreadTime;
+    float  UIBuildTime;
+    // Unfiltered value of every channel, the fields above are the filtered ones.
+    float  Raw[ChannelNum];
+    uint32 DrawCalls;
+    uint32 Primitives;
+    uint64 UsedPhysicalMemory;
+    uint64 UsedVirtualMemory;
+  };
+  static FFrameSnapshot ReadFrameSnapshot() { return PublishedFrame.Read(); }
+  // Publish as fast as possible for Seconds with Readers threads reading, and log the write cost with and without readers.
+  static bool BenchmarkFrameSnapshot(int32 Readers, float Seconds);
 
   enum EStatHeader : int {
     All = 0,
@@ -38,20 +124,163 @@ public:
   static void LoadSTAT(FDFX_StatData::EStatHeader InHeader, FString InList);
   static void LoadCVAR();
 
+  // Owned by the UI build, the game thread reads them from the FDFX_DrawDataSnapshot it acquired.
   static inline bool bMainWindowOpen = false;
   static inline bool bExternalWindow = false;
   static inline bool bDisableGameControls = true;
+  // Overlay rebuild rate in Hz, 0 rebuilds every frame. Otherwise the overlay is cached in a render target.
+  // Set by the UI build and by console commands on the game thread.
+  static inline TAtomic<int32> OverlayUpdateRate { 0 };
+  // Overlay cost budget in ms per frame (game thread share plus UI build), 0 (default) disables the governor.
+  // Over budget the overlay degrades one level at a time, stepping back up is a probe that backs off when it fails.
+  enum EOverlayDegrade : int {
+    DegradeNone = 0,      // Full overlay.
+    DegradeRate30 = 1,    // Rebuilt at 30 Hz at most.
+    DegradeRate15 = 2,    // 15 Hz, history keeps one sample out of 2.
+    DegradeMinimal = 3,   // 5 Hz, one sample out of 4, Engine/Shaders/STAT tabs skipped.
+    DegradeSuspended = 4, // No rebuild, samples still reach the history, the last overlay is composited.
+  };
+  static inline std::atomic<float> OverlayBudgetMs { 0.f };
+  // Governor state as of the last UI task launch, the game thread keeps its own copy.
+  static inline int OverlayDegradeLevel = DegradeNone;
+  static inline float OverlayCostMs = 0.f;
+  // Font atlas settings, any change bumps FontAtlasRevision to rebuild the atlas.
+  // PF_G8 font atlas, a quarter of the RGBA32 memory. Used only when the M_ImGui_A8 material is loaded.
+  static inline bool bFontAlpha8 = true;
+  static inline FString FontGlyphRanges = TEXT("0x0020-0x007E");
+  static inline int FontAtlasRevision = 0;
+  // Points of the DFoundryFX.StressPlot line, 0 hides it.
+  static inline int StressPlotPoints = 0;
 
-  static void AddShaderLog(int Type, FString Hash, double Time);
+  // PSO/shader events, fixed-size records. Producers can be any thread and never allocate,
+  // the UI build drains the queue once per frame into ShaderCompilerLog.
+  struct FShaderLogEvent {
+    int Type;
+    double Time;
+    FSHAHash Hash;
+  };
+  static void AddShaderLog(int Type, const FSHAHash& Hash, double Time);
+  static inline FThreadSafeCounter DroppedShaderEvents;
+  // Fire EventsPerProducer events from Producers threads into a private queue and check nothing is lost or reordered.
+  static bool StressShaderLog(int32 Producers, int32 EventsPerProducer);
+  // Feed Samples values of a known distribution to a private tracker, log the cost per sample and check the quantiles.
+  static bool BenchmarkPercentiles(int32 Samples);
+  // Any thread: record the engine stat of that short name into its own history column, see StatChannels.
+  static void BindStatChannel(const FString& StatName);
+  static void UnbindStatChannels();
 
 private:
   static inline bool bIsDefaultLoaded = false;
   static void LoadDefaultValues(FVector2D InViewportSize);
 
-  static inline UGameViewportClient* m_Viewport;
   static inline FVector2D ViewSize;
+  static inline TArray<FString> EnabledStats;
+
+  // Game-thread state shown by the Engine, Shaders and Debug tabs, copied by PrepareDFoundryFX.
+  // The UI build reads this copy only, never the viewport, GEngine or the console variables.
+  struct FEngineContext {
+    bool bCaptured = false;
+    // Console variables.
+    int32 MaxFPS;
+    bool bVSync;
+    int32 ScreenPercentage;
+    int32 ResolutionQuality;
+    int32 ViewDistanceScale;
+    int32 PostProcessQuality;
+    int32 ShadowQuality;
+    int32 TextureQuality;
+    int32 EffectsQuality;
+    int32 DetailMode;
+    int32 SkeletalMeshLODBias;
+    int32 FullscreenMode;
+    bool bPipelineCacheEnabled;
+    int32 PipelineCacheBatchSize;
+    int32 PipelineCacheBackgroundBatchSize;
+    bool bPipelineCacheLogPSO;
+    bool bPipelineCacheSaveAfterPSOsLogged;
+    // Viewport, named after the getters, engine members keep their own type so InfoHelper shows them unchanged.
+    decltype(UGameViewportClient::bIsPlayInEditorViewport) bIsPlayInEditorViewport;
+    float GetDPIScale;
+    float GetDPIDerivedResolutionFraction;
+    bool IsCursorVisible;
+    bool IsForegroundWindow;
+    bool IsExclusiveFullscreen;
+    bool IsFullscreen;
+    bool IsGameRenderingEnabled;
+    bool IsHDRViewport;
+    bool IsKeyboardAvailable;
+    bool IsMouseAvailable;
+    bool IsPenActive;
+    bool IsPlayInEditorViewport;
+    bool IsSlateViewport;
+    bool IsSoftwareCursorVisible;
+    bool IsStereoRenderingAllowed;
+    // GEngine.
+    bool IsEditor;
+    bool IsAllowedFramerateSmoothing;
+    decltype(UEngine::bForceDisableFrameRateSmoothing) bForceDisableFrameRateSmoothing;
+    decltype(UEngine::bSmoothFrameRate) bSmoothFrameRate;
+    decltype(UEngine::MinDesiredFrameRate) MinDesiredFrameRate;
+    decltype(UEngine::bUseFixedFrameRate) bUseFixedFrameRate;
+    decltype(UEngine::FixedFrameRate) FixedFrameRate;
+    decltype(UEngine::bCanBlueprintsTickByDefault) bCanBlueprintsTickByDefault;
+    bool IsControllerIdUsingPlatformUserId;
+    bool IsStereoscopic3D;
+    bool IsVanillaProduct;
+    bool HasMultipleLocalPlayers;
+    bool AreEditorAnalyticsEnabled;
+    decltype(UEngine::bAllowMultiThreadedAnimationUpdate) bAllowMultiThreadedAnimationUpdate;
+    decltype(UEngine::bDisableAILogging) bDisableAILogging;
+    decltype(UEngine::bEnableOnScreenDebugMessages) bEnableOnScreenDebugMessages;
+    decltype(UEngine::bEnableOnScreenDebugMessagesDisplay) bEnableOnScreenDebugMessagesDisplay;
+    decltype(UEngine::bEnableEditorPSysRealtimeLOD) bEnableEditorPSysRealtimeLOD;
+    decltype(UEngine::bEnableVisualLogRecordingOnStart) bEnableVisualLogRecordingOnStart;
+    decltype(UEngine::bGenerateDefaultTimecode) bGenerateDefaultTimecode;
+    decltype(UEngine::bIsInitialized) bIsInitialized;
+    decltype(UEngine::bLockReadOnlyLevels) bLockReadOnlyLevels;
+    decltype(UEngine::bOptimizeAnimBlueprintMemberVariableAccess) bOptimizeAnimBlueprintMemberVariableAccess;
+    decltype(UEngine::bPauseOnLossOfFocus) bPauseOnLossOfFocus;
+    decltype(UEngine::bRenderLightMapDensityGrayscale) bRenderLightMapDensityGrayscale;
+    decltype(UEngine::bShouldGenerateLowQualityLightmaps_DEPRECATED) bShouldGenerateLowQualityLightmaps_DEPRECATED;
+    decltype(UEngine::BSPSelectionHighlightIntensity) BSPSelectionHighlightIntensity;
+    decltype(UEngine::bStartedLoadMapMovie) bStartedLoadMapMovie;
+    decltype(UEngine::bSubtitlesEnabled) bSubtitlesEnabled;
+    decltype(UEngine::bSubtitlesForcedOff) bSubtitlesForcedOff;
+    decltype(UEngine::bSuppressMapWarnings) bSuppressMapWarnings;
+    decltype(UEngine::DisplayGamma) DisplayGamma;
+    bool IsAutosaving;
+    decltype(UEngine::MaximumLoopIterationCount) MaximumLoopIterationCount;
+    decltype(UEngine::MaxLightMapDensity) MaxLightMapDensity;
+    decltype(UEngine::MaxOcclusionPixelsFraction) MaxOcclusionPixelsFraction;
+    decltype(UEngine::MaxParticleResize) MaxParticleResize;
+    decltype(UEngine::MaxParticleResizeWarn) MaxParticleResizeWarn;
+    decltype(UEngine::MaxPixelShaderAdditiveComplexityCount) MaxPixelShaderAdditiveComplexityCount;
+    decltype(UEngine::UseStaticMeshMinLODPerQualityLevels) UseStaticMeshMinLODPerQualityLevels;
+    // STAT HITCHES, only filled while the engine stat is enabled.
+    FStatHitchesData StatHitches;
+  };
+  static inline FEngineContext EngineContext;
+  static void CaptureEngineContext(UGameViewportClient* Viewport);
+
+  // Console commands issued by the UI build, run on the game thread by the next PrepareDFoundryFX.
+  static inline TArray<FString> PendingCommands;
+  static void ConsoleCommand(const FString& Command);
 
-  static void UpdateStats();
+  static void UpdateStats(const FFrameSample& Sample);
+  // Smoothing of each channel (EDFX_Filter), the time constant and window are in seconds.
+  static inline int FilterModes[ChannelNum] = {};
+  static inline float FilterTimeConstant = 0.15f;
+  static inline float FilterWindow = 0.5f;
+  static inline FDFX_MetricFilter Filters[ChannelNum];
+  static inline float LastImGuiThreadTime = 0.f;
+  static inline int HistorySkipped = 0;
+  static bool DrawDegradedTab();
+
+  // Lock-free single producer / single consumer rings: game thread -> collector thread -> UI build.
+  static inline TCircularQueue<FFrameClock> FrameClocks { 256 };
+  static inline TCircularQueue<FFrameSample> FrameSamples { 1024 };
+  static inline FThreadSafeCounter DroppedFrameSamples;
+  static inline double LastPublishedTime = 0;
   static void MainWindow();
 
   static void Tab_Engine();
@@ -64,7 +293,8 @@ private:
   static inline bool bPlotsSort = true;
   static inline bool bShowDebugTab = true;
 
-  static inline const int StatHistoryMax = 10;
+  static inline const int StatHistoryMax = 10; // seconds of raw samples, longer windows use HistoryLevels
+  static inline const int StatHistoryLongMax = 4 * 3600;
   static inline float StatHistoryGlobal = 3.0f; // seconds
   struct FPlotWindow {
     FPlotWindow() {} // D11.DH: Clang bug https://github.com/llvm/llvm-project/issues/36032
@@ -81,10 +311,15 @@ private:
     ImVec4 MarkerColor = ImVec4(0.0, 0.25, 0.0, 1.0);
     float MarkerLine = 16.667;
     float MarkerThick = 1;
+    // Indices in StatChannels of the engine stats drawn over the plot.
+    TArray<int32> StatChannels;
   };
   static inline FPlotWindow pwThread;
   static inline FPlotWindow pwFrame;
   static inline FPlotWindow pwFPS;
+  // Frame time distribution, from the percentile histograms of the frame channel (window or session).
+  static inline FPlotWindow pwHistogram;
+  static inline bool bHistogramSession = false;
 
   struct FThreadColors {
     bool bShowFramePlot;
@@ -96,63 +331,171 @@ private:
   static void LoadThreadPlot();
   static void LoadFramePlot();
   static void LoadFPSPlot();
+  static void LoadHistogramPlot();
 
   static void LoadDemos();
+  static void LoadStressPlot();
+
+  // History capacity follows StatHistoryGlobal and the observed sample rate, see FitHistory.
+  static inline const int HistoryInitialSize = 1024;
+  static inline const int HistoryMinSize = 64;
+  static inline const int HistoryMaxSize = 32768;
+  // Filtered value of every channel at every sample: columns 0 to ChannelNum - 1 are the EHistoryChannel channels,
+  // RegisterHistoryChannel adds more. Times are relative to HistoryBaseTime, moved every HistoryRebaseSeconds so
+  // float times keep a sub-millisecond resolution.
+  static inline FDFX_HistoryRing History { HistoryInitialSize, ChannelNum };
+  // Names of the columns added by RegisterHistoryChannel, from ChannelNum on.
+  static inline TArray<FString> HistoryChannelNames;
+  static inline double HistoryBaseTime = 0;
+  static inline const double HistoryRebaseSeconds = 1024;
+  static int32 RegisterHistoryChannel(const FString& Name);
+  static void SetHistoryValue(int32 Channel, float Value) { History.Set(Channel, Value); }
+  static void RebaseHistory(double NewBaseTime);
+  static void FitHistory();
+  static void ResizeHistory(int NewCapacity);
+  static inline double HistorySampleInterval = 0;
+  static inline double LastHistoryTime = 0;
+  static inline double LastHistoryFit = 0;
+
+  // Long history for soak tests: level 0 keeps 100 ms buckets for 10 minutes, level 1 keeps 1 s buckets for 4 hours.
+  // Level 0 is fed with every sample by UpdateStats, each bucket it closes is merged into level 1.
+  struct FHistoryBucket {
+    double Count = 0;
+    double Min[ChannelNum];
+    double Max[ChannelNum];
+    double Sum[ChannelNum];
+    void Merge(const FHistoryBucket& Other);
+  };
+  struct FHistoryLevel {
+    FHistoryLevel(double InBucketSeconds, int InCapacity);
+    double BucketSeconds;
+    double BucketEnd = 0;
+    FHistoryBucket Bucket;
+    double ClosedTime = 0;
+    // Closed buckets at their centre time: column 0 is the sample count, then min, max and mean of every channel.
+    FDFX_HistoryRing Ring;
+    static int32 MinColumn(int32 Channel) { return 1 + Channel * 3; }
+    static int32 MaxColumn(int32 Channel) { return 2 + Channel * 3; }
+    static int32 MeanColumn(int32 Channel) { return 3 + Channel * 3; }
+    // Returns true when InTime started a new bucket, the closed one is then the last row of Ring.
+    bool Add(double InTime, const FHistoryBucket& Sample);
+    void Erase();
+  };
+  static inline FHistoryLevel HistoryLevels[2] = { { 0.1, 6000 }, { 1.0, 4 * 3600 } };
+  static void AddHistoryLevels(double InTime, const FHistoryBucket& Sample);
+  // Plots a History channel over the last Window seconds, or the mean and min/max band of the level that fits
+  // a longer Window.
+  static void PlotHistory(const char* Label, EHistoryChannel Channel, double Window, ImPlotLineFlags LineFlags, ImPlotShadedFlags ShadeFlags);
+
+  // Tail latency of every channel over the last StatHistoryMax seconds and over the session, fed with the same
+  // unsmoothed samples as the long history. Quantiles are refreshed 4 times per second.
+  static inline TDFX_PercentileTracker<ChannelNum> Percentiles { StatHistoryMax, 16384 };
+  static inline double LastPercentileUpdate = 0;
+
+  // What bounded a frame: the slowest of the game, render, GPU and RHI times, or the present when the frame spent
+  // a large share waiting in swap / VSync rather than working.
+  enum EBoundThread : uint8 {
+    BoundGame,
+    BoundRender,
+    BoundGPU,
+    BoundRHI,
+    BoundPresent,
+    BoundNum
+  };
+  static EBoundThread ClassifyFrame();
+  // Share of each class over the raw history window, counts kept incrementally over a ring of classified frames.
+  struct FBoundSample {
+    double Time;
+    EBoundThread Bound;
+  };
+  static inline TArray<FBoundSample> BoundSamples;
+  static inline int32 BoundHead = 0;
+  static inline int32 BoundCount = 0;
+  static inline int32 BoundCounts[BoundNum] = {};
+  static void AddBoundSample(EBoundThread Bound);
+  static float GetBoundShare(EBoundThread Bound) { return BoundCount > 0 ? BoundCounts[Bound] / static_cast<float>(BoundCount) : 0.f; }
+  static void DrawBoundBar(float Width);
+
+  // Hitch detector, run by UpdateStats on every raw sample: a frame is a hitch above HitchMedianFactor times the
+  // windowed P50 frame time, or above HitchBudgetMs when it is set. Events go to a ring of the last HitchLogSize.
+  struct FHitchEvent {
+    double Time;
+    uint64 FrameNumber;
+    float FrameTime;
+    float Threshold;
+    float GameThreadTime;
+    float RenderThreadTime;
+    float GPUFrameTime;
+    float RHIThreadTime;
+    EBoundThread BoundThread;
+  };
+  static inline float HitchMedianFactor = 2.5f;
+  static inline float HitchBudgetMs = 0.f;
+  static inline const int32 HitchLogSize = 256;
+  static inline TArray<FHitchEvent> HitchLog;
+  static inline int32 HitchLogHead = 0;
+  static inline int32 HitchCount = 0;
+  static void DetectHitch();
+  static void DrawHitchLog();
+
+  // Frame pacing over the last PacingWindow raw frame intervals, O(1) per frame: running sums of the frame-to-frame
+  // delta, missed intervals (above 1.5 target intervals) and alternating long/short frames. The target is
+  // PacingTargetMs, or the t.MaxFPS cap read on the game thread, or the windowed P50 frame time.
+  static inline const int32 PacingWindow = 256;
+  static inline float PacingDeltas[PacingWindow] = {};
+  static inline uint8 PacingFlags[PacingWindow] = {};
+  static inline int32 PacingHead = 0;
+  static inline int32 PacingCount = 0;
+  static inline double PacingSum = 0;
+  static inline double PacingSumSq = 0;
+  static inline int32 PacingMissed = 0;
+  static inline int32 PacingAlternating = 0;
+  static inline uint64 PacingMissedTotal = 0;
+  static inline float PacingTargetMs = 0.f;
+  static inline float PacingCapMs = 0.f;
+  static inline float LastFrameInterval = 0.f;
+  static inline float LastFrameDelta = 0.f;
+  // History column of the frame delta, registered by LoadDefaultValues.
+  static inline int32 PacingChannel = INDEX_NONE;
+  static float GetPacingTarget();
+  static void UpdatePacing();
+  static void DrawPacing();
+
+  // Engine stats bound by short name (STAT_InitViews, a game DECLARE_CYCLE_STAT...), each recorded into its own
+  // history column. BindStatChannel queues the name from any thread, UpdateStats adds the column and hands the name
+  // to the stats thread. When the stats thread publishes a frame it takes the inclusive value of the bound stats,
+  // milliseconds for cycle counters, and publishes them through a seqlock. Every stat name it meets is resolved to
+  // a channel once and kept in a map. A bound name is looked up every stats frame until its module declares it,
+  // its stat group is then enabled by the game thread. Needs a STATS build.
+  static inline const int32 MaxStatChannels = 32;
+  struct FStatChannelValues {
+    float Values[MaxStatChannels];
+    // One bit per channel the stats thread does not know yet.
+    uint32 Unresolved;
+  };
+  struct FStatChannel {
+    FString Name;
+    int32 Column;
+    ImVec4 Color;
+  };
+  static inline TArray<FStatChannel> StatChannels;
+  static inline TDFX_SeqLock<FStatChannelValues> StatChannelValues;
+  static inline TDFX_MpscQueue<FName, 64> PendingStatBinds;
+  static inline TDFX_MpscQueue<FName, 64> PendingStatChannels;
+  // Stat groups of the resolved channels, queued by the stats thread and enabled by PrepareDFoundryFX.
+  static inline TDFX_MpscQueue<FName, 64> PendingStatGroups;
+  static inline bool bStatChannelsSubscribed = false;
+  static void UpdateStatChannels();
+  static void OnStatsNewFrame(int64 StatsFrame);
+  static void PlotStatChannels(const FPlotWindow& Window);
 
-  static inline const int HistoryMaxSize = 600;
-  struct FHistoryBuffer {
-    // Fix for VS error: E0291: no default constructor exists for class
-    FHistoryBuffer() {
-      MaxSize = HistoryMaxSize;
-      Offset = 0;
-      Data.reserve(HistoryMaxSize);
-    }
-    int MaxSize;
-    int Offset;
-    ImVector<double> Data;
-    void Add(double Value) {
-      if (Data.size() < MaxSize)
-      {
-        Data.push_back(Value);
-      } else {
-        Data[Offset] = Value;
-        Offset = (Offset + 1) % MaxSize;
-      }
-    }
-    void Erase() {
-      if (Data.size() > 0) {
-        Data.shrink(0);
-        Offset = 0;
-      }
-    }
-  };
-
-  static inline double m_CurrentTime;
-  static inline double m_LastTime;
-  static inline double m_DiffTime;
-  static inline int32  m_FrameCount;
-  static inline float  m_FrameTime;
-  static inline int    m_FramesPerSecond;
-  static inline float  m_GameThreadTime;
-  static inline float  m_RenderThreadTime;
-  static inline float  m_GPUFrameTime;
-  static inline float  m_RHIThreadTime;
-  static inline float  m_SwapBufferTime;
-  static inline float  m_InputLatencyTime;
-  static inline float  m_ImGuiThreadTime;
+  // Working copy of the sampling path (UpdateStats), everything that draws reads PublishedFrame.
+  static inline FFrameSnapshot Frame {};
+  static inline TDFX_SeqLock<FFrameSnapshot> PublishedFrame;
+  // Copy of PublishedFrame taken once per build, the windows and tabs of that build all show the same frame.
+  static inline FFrameSnapshot ShownFrame {};
 
   static inline double ImPlotFrameCount;
-  static inline FHistoryBuffer HistoryTime;
-  static inline FHistoryBuffer FrameCount;
-  static inline FHistoryBuffer FrameTime;
-  static inline FHistoryBuffer FramesPerSecond;
-  static inline FHistoryBuffer GameThreadTime;
-  static inline FHistoryBuffer RenderThreadTime;
-  static inline FHistoryBuffer GPUFrameTime;
-  static inline FHistoryBuffer RHIThreadTime;
-  static inline FHistoryBuffer SwapBufferTime;
-  static inline FHistoryBuffer InputLatencyTime;
-  static inline FHistoryBuffer ImGuiThreadTime;
 
   static inline ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoTitleBar |
     ImGuiWindowFlags_NoBringToFrontOnFocus |
@@ -186,7 +529,7 @@ private:
     ImPlotDragToolFlags_NoInputs;
 
   static inline void ToggleButton(const char* str_id, bool* v);
-  static inline void ToggleStat(FString StatName, bool& bValue);
+  static inline void ToggleStat(const FStatCmd& Stat, bool bValue);
   static inline void HelpMarker(const char* desc);
   static inline void ThreadMarker(int PlotColorId);
   static inline void InfoHelper(FString InInfo, bool InValue);
@@ -205,7 +548,10 @@ private:
     int Type;
     int Count;
     double Time;
-    FString Hash;
+    FSHAHash Hash;
   };
   static inline TArray<FShaderCompilerLog> ShaderCompilerLog;
+  static inline TMap<FSHAHash, int32> ShaderCompilerLogIndex;
+  static inline TDFX_MpscQueue<FShaderLogEvent, 4096> ShaderLogEvents;
+  static void DrainShaderLog();
 };
\ No newline at end of file
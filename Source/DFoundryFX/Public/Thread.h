@@ -7,6 +7,7 @@
 #include "Misc/SingleThreadRunnable.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "Async/Async.h"
+#include "Misc/CoreDelegates.h"
 
 // Events -> GameMode and Viewport
 #include "UnrealClient.h"
@@ -29,6 +30,11 @@
 #include "GenericPlatform/GenericPlatformApplicationMisc.h"
 #include "UObject/ConstructorHelpers.h"
 #include "ImGui/imgui.h"
+#include "Renderer.h"
+#include "TripleBuffer.h"
+#include "CanvasItem.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Kismet/KismetRenderingLibrary.h"
 
 // Stats
 #include "Module.h"
@@ -55,11 +61,14 @@ public:  //Thread
   bool HasThreadStopped();
 
 protected:
-  bool bStopping = false;
+  FThreadSafeBool bStopping = false;
   FThreadSafeBool bPaused;
   FThreadSafeBool bIsVerifiedSuspended;
   FThreadSafeBool bHasStopped;
   FRunnableThread* DFoundryFX_Thread = nullptr;
+  // Frame clocks are published by the game thread at the end of every frame, the collector turns them into samples.
+  FDelegateHandle hOnEndFrame;
+  void CollectFrame();
 
 
 public:  // Events -> GameMode and Viewport
@@ -87,15 +96,18 @@ public:  // Events -> GameMode and Viewport
 
   FDelegateHandle hOnPipelineStateLogged;
   void OnPipelineStateLogged(FPipelineCacheFileFormatPSO& PipelineCacheFileFormatPSO);
-  double ShaderLogTime = 0;
+  TAtomic<uint64> ShaderLogCycles { 0 };
 
 public:  // ImGui
   bool ImGui_ImplUE_Init();
   bool ImGui_ImplUE_CreateDeviceObjects();
+  void ImGui_ImplUE_UpdateFontAtlas();
   void ImGui_ImplUE_ProcessEvent();
   void ImGui_ImplUE_NewFrame();
+  void ImGui_ImplUE_BuildFrame(uint64 ImGuiThreadTime);
   void ImGui_ImplUE_Render();
-  void ImGui_ImplUE_RenderDrawLists();
+  void ImGui_ImplUE_RenderDrawLists(UCanvas* Canvas, bool bOverlayTarget = false);
+  void BenchmarkRenderer(int32 Frames);
 
   static const char* ImGui_ImplUE_GetClipboardText(void* user_data);
   static void ImGui_ImplUE_SetClipboardText(void* user_data, const char* text);
@@ -104,6 +116,76 @@ private:
   FORCEINLINE ImGuiIO& GetImGuiIO() const;
   ImGuiContext* m_ImGuiContext = nullptr;
   ImPlotContext* m_ImPlotContext = nullptr;
+  FDFX_Renderer m_Renderer;
+  int m_StressPlotValidated = 0;
+  // Frames left before the stress plot reaches the renderer, through the UI build and the draw data hand-off.
+  int m_StressPlotValidateIn = 0;
+
+  // Input captured on the game thread since the last UI build, applied to the ImGui IO by the next one.
+  // Taps and clicks shorter than a build are kept so they can be replayed as a press/release pair.
+  struct FInputFrame {
+    ImVec2 DisplaySize = ImVec2(0, 0);
+    ImVec2 MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+    bool MouseDown[3] = {};
+    bool MouseClicked[3] = {};
+    bool bKeyboard = false;
+    bool KeyShift = false;
+    bool KeyCtrl = false;
+    bool KeyAlt = false;
+    TArray<ImGuiKey> KeysDown;
+    TArray<ImGuiKey> KeysPressed;
+    TArray<ImWchar> Characters;
+    void ResetEvents();
+  };
+  FInputFrame m_Input;
+  FInputFrame m_BuildInput;
+  static void ImGui_ImplUE_ApplyInput(ImGuiIO& IO, const FInputFrame& Input);
+
+  // The UI (NewFrame, FDFX_StatData::RunDFoundryFX, Render) is built by a task graph task, at most one in flight.
+  // The game thread never touches the ImGui context while it runs, it submits the last frame published in m_DrawData.
+  TFuture<void> m_UIBuildTask;
+  TDFX_TripleBuffer<FDFX_DrawDataSnapshot> m_DrawData;
+  uint64 m_UIBuildTime = 0;
+  bool IsUIBuildIdle() const { return !m_UIBuildTask.IsValid() || m_UIBuildTask.IsReady(); }
+  void WaitUIBuildTask();
+
+  // Font atlas rebuilt on a worker when the viewport DPI scale changes, published through m_PendingFontAtlas
+  // and swapped in on the game thread between two frames.
+  float m_FontDPIScale = 1.f;
+  int m_FontAtlasRevision = 0;
+  TAtomic<ImFontAtlas*> m_PendingFontAtlas { nullptr };
+  TFuture<void> m_FontAtlasTask;
+  // Texture of the swapped atlas, applied to the renderer once the first frame built with it is acquired.
+  UTexture2D* m_PendingFontTexture = nullptr;
+  bool m_bPendingFontAlpha8 = false;
+  void ApplyPendingFontTexture();
+  void WaitFontAtlasTask();
+  static bool UseFontAlpha8();
+  static void ParseGlyphRanges(const FString& InRanges, TArray<ImWchar>& OutRanges);
+  static void BuildFontAtlas(ImFontAtlas* Atlas, float DPIScale, const TArray<ImWchar>& GlyphRanges, bool bAlpha8);
+  static void UploadFontTexture(UTexture2D*& Texture, ImFontAtlas* Atlas, bool bAlpha8);
+  static void ApplyFontTexture(UTexture2D* Texture, bool bAlpha8);
+
+  // Cached overlay, used when FDFX_StatData::OverlayUpdateRate is set.
+  UTextureRenderTarget2D* m_OverlayTarget = nullptr;
+  double m_OverlayLastUpdate = 0;
+  void ImGui_ImplUE_RenderOverlayTarget();
+  void ImGui_ImplUE_CompositeOverlay();
+  void ReleaseOverlayTarget();
+
+  // Overlay cost governor, see FDFX_StatData::OverlayBudgetMs.
+  // Game-thread owned, copied to FDFX_StatData::OverlayCostMs/OverlayDegradeLevel before each UI task is launched.
+  double m_OverlayCostMs = 0;
+  int m_OverlayDegradeLevel = FDFX_StatData::DegradeNone;
+  double m_OverlayLevelTime = 0;
+  // Seconds a level is held before probing the one above, doubled by every probe dropped within a few seconds.
+  double m_OverlayProbeDelay = 2.0;
+  bool m_bOverlayProbing = false;
+  void ImGui_ImplUE_SampleOnly();
+  int GetOverlayUpdateRate() const;
+  void UpdateOverlayBudget(uint64 FrameCycles, double CurrentTime);
+  void SetOverlayDegradeLevel(int Level, double CurrentTime);
+  void PrepareOverlayBudget();
 
   uint64 m_ImGuiDiffTime;
 
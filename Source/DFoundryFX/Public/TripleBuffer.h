@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Lock-free hand-off between one writer and one reader thread. The writer fills GetWriteBuffer() and publishes it,
+// the reader takes the latest published buffer with Acquire(). Neither side ever waits for the other, a buffer
+// published twice before the reader acquires it is simply overwritten.
+template <typename T>
+class TDFX_TripleBuffer
+{
+public:
+  // Writer side.
+  T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+  void Publish()
+  {
+    WriteIndex = Shared.Exchange(WriteIndex | FreshBit) & IndexMask;
+  }
+
+  // Reader side, returns true when a buffer was published since the last Acquire.
+  bool Acquire()
+  {
+    if ((Shared.Load(EMemoryOrder::Relaxed) & FreshBit) == 0)
+      return false;
+    ReadIndex = Shared.Exchange(ReadIndex) & IndexMask;
+    return true;
+  }
+  T& GetReadBuffer() { return Buffers[ReadIndex]; }
+
+private:
+  static constexpr int32 IndexMask = 0x3;
+  static constexpr int32 FreshBit = 0x4;
+
+  T Buffers[3];
+  int32 WriteIndex = 0;
+  TAtomic<int32> Shared { 1 };
+  int32 ReadIndex = 2;
+};
\ No newline at end of file